@@ -0,0 +1,144 @@
+// Two-stage solve of the problem of 1_cmp_pgd_ex.cpp
+//
+//   min  15*(x1^2-1)^2 + (x2^2-2)^2 + 4*x1*x2 + x1 + x2
+//   s.t. g(x) = x1^2 + (x2-1.2)^2 <= 0.5^2
+//
+// Stage 1 runs the codegen PGD (PGD_API_s) to a loose tolerance. The
+// multiplier of g is estimated from stationarity at the PGD point, and
+// stage 2 polishes with a prebuilt Ipopt started from that primal-dual
+// point (warm_start_init_point). The total latency is compared with
+// Ipopt from a cold start over the same random start set.
+//
+// Usage: hybrid [n_starts] [pgd_tol]
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <casadi/casadi.hpp>
+#include "casadi_api_a_test/casadi_api_a_test.hpp"
+#include "PGD_example/pgd_problems.hpp"
+#include "bench_util.h"
+
+/**
+ * @brief PGD to a loose tolerance, then an Ipopt polish from the PGD point
+ */
+class Hybrid_solver {
+public:
+    Hybrid_solver(const casadi::MXDict& nlp, const casadi::Dict& opts, double pgd_tol)
+        : polish(casadi::nlpsol("polish", "ipopt", nlp, warm_options(opts))) {
+        pgd.set_tolerance(pgd_tol);
+        arg["lbg"] = -casadi::inf;
+        arg["ubg"] = problem.radius * problem.radius;
+    }
+
+    /**
+     * @brief Solve from X_init; returns the Ipopt result
+     */
+    casadi::DMDict solve(const Eigen::Vector2d& X_init) {
+        pgd.solve(X_init);
+        Eigen::Vector2d X = pgd.solution();
+
+        arg["x0"] = casadi::DM(std::vector<double>{X(0), X(1)});
+        arg["lam_g0"] = multiplier_estimate(X);
+        return polish(arg);
+    }
+
+    const casadi::Function& solver() const { return polish; }
+    int pgd_iterations() const { return pgd.iterations(); }
+
+private:
+    // Quiet Ipopt that trusts the given starting point: warm start and a small
+    // initial barrier so the polish does not first move away from it
+    static casadi::Dict warm_options(casadi::Dict opts) {
+        opts["ipopt.warm_start_init_point"] = "yes";
+        opts["ipopt.warm_start_bound_push"] = 1e-9;
+        opts["ipopt.warm_start_mult_bound_push"] = 1e-9;
+        opts["ipopt.mu_init"] = 1e-6;
+        return opts;
+    }
+
+    /**
+     * @brief Multiplier of g at X from grad f + lambda grad g = 0
+     *
+     * Zero when the constraint is inactive at X; otherwise the least-squares
+     * lambda, clipped at zero.
+     */
+    double multiplier_estimate(const Eigen::Vector2d& X) const {
+        Eigen::Vector2d grad_f, grad_g = 2 * (X - problem.C);
+        problem.gradient(X, grad_f);
+        double r2 = problem.radius * problem.radius;
+        if ((X - problem.C).squaredNorm() < r2 * (1 - 1e-3)) return 0;
+        return std::max(0.0, -grad_f.dot(grad_g) / grad_g.squaredNorm());
+    }
+
+    Quartic_problem problem;
+    PGD_API_s pgd;
+    casadi::Function polish;
+    casadi::DMDict arg;
+};
+
+int main(int argc, char* argv[]) {
+    int n_starts = argc > 1 ? std::atoi(argv[1]) : 200;
+    double pgd_tol = argc > 2 ? std::atof(argv[2]) : 1e-4;
+
+    casadi::MX x = casadi::MX::sym("x", 2);
+    casadi::MX f = 15.0*pow(x(0)*x(0)-1, 2) + 1.0*pow(x(1)*x(1) - 2, 2) + 4.0*x(0)*x(1) + x(0) + x(1);
+    casadi::MX g = pow(x(0), 2) + pow(x(1) - 1.2, 2);
+    casadi::MXDict nlp{{"x", x}, {"f", f}, {"g", g}};
+
+    casadi::Dict opts;
+    opts["ipopt.tol"] = 1e-8;
+    opts["ipopt.print_level"] = 0;
+    opts["ipopt.sb"] = "yes";
+    opts["print_time"] = false;
+
+    casadi::Function cold = casadi::nlpsol("cold", "ipopt", nlp, opts);
+    Hybrid_solver hybrid(nlp, opts, pgd_tol);
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+    std::vector<Eigen::Vector2d> starts(n_starts);
+    for (auto& X0 : starts) X0 = Eigen::Vector2d(dist(gen), dist(gen));
+
+    casadi::DMDict arg;
+    arg["lbg"] = -casadi::inf;
+    arg["ubg"] = 0.5*0.5;
+
+    std::vector<double> t_cold, t_hybrid;
+    double iter_cold = 0, iter_polish = 0, iter_pgd = 0, f_cold = 0, f_hybrid = 0;
+    int fail_cold = 0, fail_hybrid = 0;
+
+    for (const auto& X0 : starts) {
+        arg["x0"] = casadi::DM(std::vector<double>{X0(0), X0(1)});
+        auto tic = bench_clock::now();
+        casadi::DMDict res = cold(arg);
+        t_cold.push_back(seconds_since(tic));
+        iter_cold += cold.stats().at("iter_count").as_int();
+        fail_cold += !cold.stats().at("success").as_bool();
+        f_cold += res.at("f").scalar();
+
+        tic = bench_clock::now();
+        res = hybrid.solve(X0);
+        t_hybrid.push_back(seconds_since(tic));
+        iter_polish += hybrid.solver().stats().at("iter_count").as_int();
+        iter_pgd += hybrid.pgd_iterations();
+        fail_hybrid += !hybrid.solver().stats().at("success").as_bool();
+        f_hybrid += res.at("f").scalar();
+    }
+
+    std::cout << std::setw(14) << "" << std::setw(12) << "p50[s]" << std::setw(12) << "p99[s]"
+              << std::setw(12) << "ipopt it" << std::setw(10) << "pgd it" << std::setw(12) << "mean f"
+              << std::setw(8) << "fail" << std::endl;
+    std::cout << std::setw(14) << "ipopt cold" << std::setw(12) << percentile(t_cold, 0.5)
+              << std::setw(12) << percentile(t_cold, 0.99) << std::setw(12) << iter_cold / n_starts
+              << std::setw(10) << 0 << std::setw(12) << f_cold / n_starts << std::setw(8) << fail_cold << std::endl;
+    std::cout << std::setw(14) << "pgd + ipopt" << std::setw(12) << percentile(t_hybrid, 0.5)
+              << std::setw(12) << percentile(t_hybrid, 0.99) << std::setw(12) << iter_polish / n_starts
+              << std::setw(10) << iter_pgd / n_starts << std::setw(12) << f_hybrid / n_starts
+              << std::setw(8) << fail_hybrid << std::endl;
+
+    return 0;
+}
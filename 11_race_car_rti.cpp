@@ -0,0 +1,260 @@
+// Real-time iteration (RTI) MPC for the race car OCP of
+// 4_race_car_multiple_shooting.cpp
+//
+// Instead of a full Ipopt solve per sample, every sample takes one
+// Gauss-Newton SQP step with CasADi's bundled active-set QP solver qrqp.
+// The step is split in two phases:
+//
+//   preparation  shift the last iterate by one interval and linearize the
+//                constraints there; this runs before the next state is known
+//   feedback     the measured state only enters the initial-state rows of the
+//                (affine in x0) constraints, so it just moves the QP bounds;
+//                solve the QP and apply the first control
+//
+// The objective (lap time) is linear, so the Gauss-Newton Hessian is zero
+// and a small diagonal regularization keeps the QP strictly convex. The
+// track is periodic and the finish line is relative to the start, so the
+// position is not wrapped and the preparation never waits for a measurement.
+//
+// A warm-started full Ipopt solve at the same closed-loop states is the
+// baseline: its latency and control are reported next to the RTI ones.
+//
+// Usage: race_car_rti [n_steps] [regularization]
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdlib>
+#include <casadi/casadi.hpp>
+#include "race_car.h"
+#include "bench_util.h"
+
+using namespace casadi;
+
+// Shift a stacked vector of column-major blocks {rows, cols} by one column each
+static DM shift_blocks(const DM& v, const std::vector<std::pair<casadi_int, casadi_int>>& blocks) {
+  std::vector<DM> out;
+  casadi_int offset = 0;
+  for (const auto& b : blocks) {
+    casadi_int n = b.first * b.second;
+    out.push_back(vec(shift_columns(reshape(v(Slice(offset, offset+n)), b.first, b.second))));
+    offset += n;
+  }
+  return vertcat(out);
+}
+
+// The MPC problem of 5_race_car_mpc.cpp, race_car_ocp with the measured
+// state as parameter, as a plain NLP (x = w, p = x0) -> (f, g). w stacks the
+// Opti variables in declaration order, [vec(X); U'; T], and g the rows of
+// the constraints in subject_to order. Opti keeps no simple bounds, so all
+// bounds are on g; those of the initial-state rows may depend on x0.
+struct Race_car_nlp {
+  Function nlp;    // (x = w, p = x0) -> (f, g)
+  Function bounds; // x0 -> (lbg, ubg)
+  std::vector<std::pair<casadi_int, casadi_int>> w_blocks, g_blocks;
+};
+
+static Race_car_nlp race_car_nlp(int N) {
+  Opti opti;
+  MX x0 = opti.parameter(2);
+  Race_car_ocp o = race_car_ocp(opti, N, "serial", x0);
+
+  Race_car_nlp ocp;
+  ocp.nlp = Function("nlp", {opti.x(), opti.p()}, {opti.f(), opti.g()}, {"x", "p"}, {"f", "g"});
+  ocp.bounds = Function("bounds", {opti.p()}, {opti.lbg(), opti.ubg()}, {"p"}, {"lbg", "ubg"});
+  for (const MX& v : {o.X, o.U, o.T})
+    ocp.w_blocks.emplace_back(v.size1(), v.size2());
+  for (const MX& c : {o.con_dyn, o.con_speed, o.con_u, o.con_x0, o.con_end, o.con_T})
+    ocp.g_blocks.emplace_back(c.size1(), c.size2());
+  return ocp;
+}
+
+class Race_car_rti {
+public:
+  /**
+   * @brief Build the linearization and the QP solver
+   * @param reg Diagonal of the Gauss-Newton Hessian
+   */
+  Race_car_rti(const Race_car_nlp& ocp, double reg) : ocp(ocp) {
+    casadi_int n = ocp.nlp.nnz_in(0);
+    MX w  = MX::sym("w", n);
+    MX x0 = MX::sym("x0", 2);
+    MXDict r = ocp.nlp(MXDict{{"x", w}, {"p", x0}});
+    MX g = r.at("g");
+    std::vector<MX> b = ocp.bounds(std::vector<MX>{x0});
+
+    // Constraints at x0 = 0 and their Jacobian, evaluated in the preparation
+    lin = Function("lin", {w, x0}, {g, jacobian(g, w)});
+    // g and its bounds are affine in x0 and f = T is linear in w: all
+    // derivatives are constant
+    Function consts("consts", {w, x0}, {jacobian(g, x0), jacobian(b[0], x0), jacobian(b[1], x0),
+                                        gradient(r.at("f"), w), b[0], b[1]});
+    std::vector<DM> c = consts(std::vector<DM>{DM::zeros(n), DM::zeros(2)});
+    B = densify(c[0]);
+    B_lb = densify(c[1]);
+    B_ub = densify(c[2]);
+    lbg0 = c[4];
+    ubg0 = c[5];
+
+    Dict opts;
+    opts["print_iter"] = false;
+    opts["print_header"] = false;
+    opts["error_on_fail"] = false;
+    qp = conic("qp", "qrqp", {{"h", Sparsity::diag(n)}, {"a", lin.sparsity_out(1)}}, opts);
+
+    arg["h"] = reg * DM::eye(n);
+    arg["g"] = densify(c[1]);
+    arg["x0"] = DM::zeros(n);
+  }
+
+  /**
+   * @brief Set the primal-dual iterate, e.g. from a converged full solve
+   */
+  void initialize(const DM& w_init, const DM& lam_x, const DM& lam_g) {
+    w = w_init;
+    applied = false;
+    arg["lam_x0"] = lam_x;
+    arg["lam_a0"] = lam_g;
+  }
+
+  /**
+   * @brief Shift the iterate by one interval if a control was applied, and
+   * linearize there
+   */
+  void prepare() {
+    if (applied) {
+      w = shift_blocks(w, ocp.w_blocks);
+      arg["lam_x0"] = shift_blocks(arg["lam_x0"], ocp.w_blocks);
+      arg["lam_a0"] = shift_blocks(arg["lam_a0"], ocp.g_blocks);
+    }
+
+    std::vector<DM> r = lin(std::vector<DM>{w, DM::zeros(2)});
+    g0 = r[0];
+    arg["a"] = r[1];
+  }
+
+  /**
+   * @brief One QP step from the measured state; returns the first control
+   */
+  double feedback(const DM& x0) {
+    DM g = g0 + mtimes(B, x0);
+    arg["lba"] = lbg0 + mtimes(B_lb, x0) - g;
+    arg["uba"] = ubg0 + mtimes(B_ub, x0) - g;
+    DMDict res = qp(arg);
+    success = qp.stats().at("success").as_bool();
+
+    w += res.at("x");
+    arg["lam_x0"] = res.at("lam_x");
+    arg["lam_a0"] = res.at("lam_a");
+    applied = true;
+    return u0();
+  }
+
+  double u0() const { return w(ocp.w_blocks[0].first * ocp.w_blocks[0].second).scalar(); }
+  double lap_time() const { return w(w.size1()-1).scalar(); }
+
+  bool success = false;
+
+private:
+  const Race_car_nlp& ocp;
+  Function lin, qp;
+  DM B, B_lb, B_ub, lbg0, ubg0, w, g0;
+  DMDict arg;
+  bool applied = false;
+};
+
+int main(int argc, char* argv[]) {
+  int N = 100;                                        // number of control intervals
+  int n_steps = argc > 1 ? std::atoi(argv[1]) : 500;  // closed-loop steps
+  double reg = argc > 2 ? std::atof(argv[2]) : 1e-3;
+
+  Race_car_nlp ocp = race_car_nlp(N);
+  Function plant = race_car_rk4();
+
+  // Baseline: full Ipopt solve, warm-started from its last solution
+  Dict opts;
+  opts["print_time"] = false;
+  opts["ipopt.print_level"] = 0;
+  opts["ipopt.sb"] = "yes";
+  opts["ipopt.warm_start_init_point"] = "yes";
+  Function full = nlpsol("full", "ipopt", ocp.nlp, opts);
+
+  DMDict full_arg;
+  DM w_init = DM::zeros(ocp.nlp.nnz_in(0));
+  w_init(Slice(1, 2*(N+1), 2)) = 1; // speed 1
+  w_init(w_init.size1()-1) = 1;     // T 1
+  full_arg["x0"] = w_init;
+
+  // Both start from a converged solve at the initial state
+  DM x_k = DM(std::vector<double>{0, 0}); // position 0 from stand-still
+  full_arg["p"] = x_k;
+  std::vector<DM> lu = ocp.bounds(std::vector<DM>{x_k});
+  full_arg["lbg"] = lu[0];
+  full_arg["ubg"] = lu[1];
+  DMDict sol = full(full_arg);
+  double T_opt = sol.at("f").scalar();
+
+  Race_car_rti rti(ocp, reg);
+  rti.initialize(sol.at("x"), sol.at("lam_x"), sol.at("lam_g"));
+
+  std::vector<double> t_prep, t_feedback, t_full, du, dT;
+  int rti_failures = 0, full_failures = 0;
+  double t_k = 0, t_lap = -1;
+
+  for (int k = 0; k < n_steps; ++k) {
+    // Full solve at the current state from the last solution, shifted
+    // once a control has been applied
+    full_arg["x0"] = k > 0 ? shift_blocks(sol.at("x"), ocp.w_blocks) : sol.at("x");
+    full_arg["lam_x0"] = k > 0 ? shift_blocks(sol.at("lam_x"), ocp.w_blocks) : sol.at("lam_x");
+    full_arg["lam_g0"] = k > 0 ? shift_blocks(sol.at("lam_g"), ocp.g_blocks) : sol.at("lam_g");
+    full_arg["p"] = x_k;
+    lu = ocp.bounds(std::vector<DM>{x_k});
+    full_arg["lbg"] = lu[0];
+    full_arg["ubg"] = lu[1];
+    auto tic = bench_clock::now();
+    sol = full(full_arg);
+    t_full.push_back(seconds_since(tic));
+    full_failures += !full.stats().at("success").as_bool();
+    double u_full = sol.at("x")(2*(N+1)).scalar();
+
+    // The preparation belongs to the previous sample period, the feedback
+    // starts when x_k arrives
+    tic = bench_clock::now();
+    rti.prepare();
+    t_prep.push_back(seconds_since(tic));
+
+    tic = bench_clock::now();
+    double u_k = rti.feedback(x_k);
+    t_feedback.push_back(seconds_since(tic));
+    rti_failures += !rti.success;
+
+    du.push_back(std::abs(u_k - u_full));
+    dT.push_back(std::abs(rti.lap_time() - sol.at("f").scalar()));
+
+    double dt = rti.lap_time() / N;
+    x_k = plant(std::vector<DM>{x_k, u_k, dt})[0];
+    t_k += dt;
+    if (t_lap < 0 && x_k(0).scalar() >= 1) t_lap = t_k;
+  }
+
+  auto mean = [](const std::vector<double>& v) {
+    double s = 0;
+    for (double x : v) s += x;
+    return s / v.size();
+  };
+
+  std::cout << "closed-loop steps: " << n_steps << ", regularization: " << reg << std::endl;
+  std::cout << "full Ipopt solve   p50: " << percentile(t_full, 0.5) << " s, p99: "
+            << percentile(t_full, 0.99) << " s, failed: " << full_failures << std::endl;
+  std::cout << "RTI preparation    p50: " << percentile(t_prep, 0.5) << " s, p99: "
+            << percentile(t_prep, 0.99) << " s" << std::endl;
+  std::cout << "RTI feedback       p50: " << percentile(t_feedback, 0.5) << " s, p99: "
+            << percentile(t_feedback, 0.99) << " s, failed QPs: " << rti_failures << std::endl;
+  std::cout << "|u_rti - u_full|   mean: " << mean(du) << ", max: " << percentile(du, 1.0) << std::endl;
+  std::cout << "|T_rti - T_full|   mean: " << mean(dT) << ", max: " << percentile(dT, 1.0) << std::endl;
+  std::cout << "first lap: " << (t_lap < 0 ? std::string("not finished") : std::to_string(t_lap) + " s")
+            << " (open-loop optimum " << T_opt << " s)" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+// Evaluation cost of the f_eval / g_eval Functions of 1_cmp_pgd_ex.cpp
+//
+//   f(x) = 15*(x1^2-1)^2 + (x2^2-2)^2 + 4*x1*x2 + x1 + x2
+//   g(x) = x1^2 + (x2-1.2)^2
+//
+// Calls per second for
+//   VM (DM)      f_eval(DM(x)): CasADi's virtual machine plus DM temporaries
+//   VM (raw)     the low-level call with preallocated work vectors
+//   JIT          Jit_function: compiled at startup, cached in jit_cache/
+//   codegen      obj_fun of libpgd_fun.a (f only), linked statically
+//
+// Usage: function_eval_bench [n_calls]
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <casadi/casadi.hpp>
+#include "jit_function.h"
+#include "casadi_api_a_test/casadi_api_a_test.hpp"
+#include "bench_util.h"
+
+int main(int argc, char* argv[]) {
+  long n_calls = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+  casadi::MX x = casadi::MX::sym("x", 2);
+  casadi::MX f = 15.0*pow(x(0)*x(0)-1, 2) + 1.0*pow(x(1)*x(1) - 2, 2) + 4.0*x(0)*x(1) + x(0) + x(1);
+  casadi::MX g = pow(x(0), 2) + pow(x(1) - 1.2, 2);
+  casadi::Function f_eval("f_eval", {x}, {f});
+  casadi::Function g_eval("g_eval", {x}, {g});
+
+  // A pool of points so no call sees a constant input
+  const int n_points = 1024;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-2.0, 2.0);
+  std::vector<double> pts(2 * n_points);
+  for (auto& p : pts) p = dist(gen);
+
+  auto tic = bench_clock::now();
+  Jit_function f_jit(f_eval), g_jit(g_eval);
+  double t_jit_setup = seconds_since(tic);
+  std::cout << "JIT setup: " << t_jit_setup << " s ("
+            << (f_jit.compiled_now() || g_jit.compiled_now() ? "compiled" : "loaded from cache")
+            << ", " << f_jit.library() << ")" << std::endl;
+
+  double sink = 0;
+  auto time_it = [&](const std::string& name, long n, auto&& body) {
+    for (int i = 0; i < n_points; i++) body(&pts[2 * i]);  // warmup
+    auto tic = bench_clock::now();
+    for (long k = 0; k < n; k++) body(&pts[2 * (k % n_points)]);
+    double t = seconds_since(tic);
+    std::cout << std::setw(16) << std::left << name << std::right
+              << std::setw(14) << n / t << " calls/s" << std::endl;
+  };
+
+  for (casadi::Function* fn : {&f_eval, &g_eval}) {
+    Jit_function& fn_jit = fn == &f_eval ? f_jit : g_jit;
+    std::cout << "-- " << fn->name() << std::endl;
+
+    // The DM interface is slow enough that a tenth of the calls suffices
+    time_it("VM (DM)", n_calls / 10, [&](const double* p) {
+      sink += (*fn)(casadi::DM(std::vector<double>{p[0], p[1]}))[0].scalar();
+    });
+
+    std::vector<const double*> arg(fn->sz_arg());
+    std::vector<double*> res(fn->sz_res());
+    std::vector<casadi::casadi_int> iw(fn->sz_iw());
+    std::vector<double> w(fn->sz_w());
+    int mem = fn->checkout();
+    double r;
+    time_it("VM (raw)", n_calls, [&](const double* p) {
+      arg[0] = p;
+      res[0] = &r;
+      (*fn)(arg.data(), res.data(), iw.data(), w.data(), mem);
+      sink += r;
+    });
+    fn->release(mem);
+
+    time_it("JIT", n_calls, [&](const double* p) {
+      const double* a[] = {p};
+      double* o[] = {&r};
+      fn_jit.eval(a, o);
+      sink += r;
+    });
+
+    if (fn == &f_eval) {
+      PGD_kernels kernels;
+      time_it("codegen", n_calls, [&](const double* p) {
+        kernels.obj(p, r);
+        sink += r;
+      });
+    }
+  }
+
+  std::cout << "checksum: " << sink << std::endl;
+  return 0;
+}
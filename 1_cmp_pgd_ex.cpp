@@ -1,10 +1,26 @@
 #include <casadi/casadi.hpp>
 #include <iostream>
+#include <memory>
+#include "solver_cache.h"
+#include "jit_function.h"
 
 using namespace casadi;
 using namespace std;
 
-int main() {
+// Value of the scalar Function fn at x, through fn_jit when given
+static double eval_scalar(const Function& fn, Jit_function* fn_jit, const std::vector<double>& x) {
+    if (!fn_jit) return fn(DM(x))[0].scalar();
+    double r;
+    const double* arg[] = {x.data()};
+    double* res[] = {&r};
+    fn_jit->eval(arg, res);
+    return r;
+}
+
+// Usage: cmp_pgd_ex [jit]
+//   jit: evaluate f_eval and g_eval as compiled code cached in jit_cache/
+int main(int argc, char* argv[]) {
+    bool jit = argc > 1 && std::string(argv[1]) == "jit";
 
     MX x = MX::sym("x", 2);  // [x1, x2]
 
@@ -13,25 +29,27 @@ int main() {
 
 
     Function f_eval = Function("f_eval", {x}, {f});
+    std::unique_ptr<Jit_function> f_jit(jit ? new Jit_function(f_eval) : nullptr);
     std::vector<double> x_val_1 = {0.499946, 1.19269};
-    DM result_1 = f_eval(DM(x_val_1))[0];
+    double result_1 = eval_scalar(f_eval, f_jit.get(), x_val_1);
     std::cout << "[Ipopt]: f(" << x_val_1[0] << ", " << x_val_1[1] << ") = " << result_1 << std::endl;
 
 
     
     std::vector<double> x_val_2 = {0.499947, 1.19269}; // 1e-6 -> 8.48031
     // std::vector<double> x_val_2 = {0.499747, 1.1841}; // 1e-0 -> 8.47034
-    DM result_2 = f_eval(DM(x_val_2))[0];
+    double result_2 = eval_scalar(f_eval, f_jit.get(), x_val_2);
     std::cout << "[PGD]: f(" << x_val_2[0] << ", " << x_val_2[1] << ") = " << result_2 << std::endl;
     
     // 제약식: (x1)^2 + (x2-1.2)^2 <= 0.5^2
     MX g1 = pow(x(0), 2) + pow(x(1) - 1.2, 2);
 
     Function g_eval = Function("g_eval", {x}, {g1});
-    DM result_3 = g_eval(DM(x_val_1))[0];
+    std::unique_ptr<Jit_function> g_jit(jit ? new Jit_function(g_eval) : nullptr);
+    double result_3 = eval_scalar(g_eval, g_jit.get(), x_val_1);
     std::cout << "[Ipopt]: g(" << x_val_1[0] << ", " << x_val_1[1] << ") = " << result_3 << std::endl;
 
-    DM result_4 = g_eval(DM(x_val_2))[0];
+    double result_4 = eval_scalar(g_eval, g_jit.get(), x_val_2);
     std::cout << "[PGD]: g(" << x_val_2[0] << ", " << x_val_2[1] << ") = " << result_4 << std::endl;
 
 
@@ -57,10 +75,17 @@ int main() {
     // opts["ipopt.linear_solver"] = "ma57";
 // ==============
 
+    // Cold start: build the solver from the expressions
     auto tic1 = std::chrono::high_resolution_clock::now();
-    Function solver = nlpsol("solver", "ipopt", nlp, opts);
+    Function solver_cold = nlpsol("solver", "ipopt", nlp, opts);
     auto tac1 = std::chrono::high_resolution_clock::now();
 
+    // Warm start: load the serialized solver (written on the first run)
+    cached_nlpsol("solver", "ipopt", nlp, opts);
+    auto tic3 = std::chrono::high_resolution_clock::now();
+    Function solver = cached_nlpsol("solver", "ipopt", nlp, opts);
+    auto tac3 = std::chrono::high_resolution_clock::now();
+
     std::vector<double> x0 = {0.2, 1};
     // std::vector<double> x0 = {-0.07, -1.45};
 
@@ -84,7 +109,9 @@ int main() {
     auto tac2 = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> duration1 = tac1 - tic1;
     std::chrono::duration<double> duration2 = tac2 - tic2;
-    std::cout << "Setting Time taken: " << duration1.count() << " seconds" << std::endl;
+    std::chrono::duration<double> duration3 = tac3 - tic3;
+    std::cout << "Setting Time taken: " << duration1.count() << " seconds (cold), "
+              << duration3.count() << " seconds (cache)" << std::endl;
     std::cout << "Solving Time taken: " << duration2.count() << " seconds" << std::endl;
 
     // 결과 출력
@@ -1,27 +1,20 @@
 #include <casadi/casadi.hpp>
+#include <cstdlib>
+#include "large_prob.h"
 using namespace casadi;
-int main() {
-    int N = 500;
-    MX x = MX::sym("x", N);
 
-    MX f = 0;
-    for (int i = 0; i < N; ++i)
-        f += pow(x(i) - i, 4) + sin(x(i)) + exp(0.1 * x(i));
-
-    std::vector<MX> g;
-    for (int i = 0; i < N-1; ++i)
-        g.push_back(pow(x(i), 2) + pow(x(i+1), 2) - 1.0);
-
-    MXDict nlp;
-    nlp["x"] = x;
-    nlp["f"] = f;
-    nlp["g"] = vertcat(g);
+// Usage: large_prob [N] [mx|sx|loop]
+int main(int argc, char* argv[]) {
+    int N = argc > 1 ? std::atoi(argv[1]) : 500;
+    std::string mode = argc > 2 ? argv[2] : "mx";
 
     Dict opts;
     opts["ipopt.max_iter"] = 10000; 
     opts["ipopt.tol"] = 1e-10;
 
-    Function solver = nlpsol("solver", "ipopt", nlp, opts);
+    Function solver = mode == "sx"
+        ? nlpsol("solver", "ipopt", large_prob_nlp<SX>(N), opts)
+        : nlpsol("solver", "ipopt", large_prob_nlp<MX>(N, mode != "loop"), opts);
 
     std::vector<double> x0(N, 0.0);
     std::vector<double> lbg(N-1, 0.0), ubg(N-1, 0.0);
@@ -35,4 +28,4 @@ int main() {
     std::cout << "최적해: " << res.at("x") << std::endl;
     std::cout << "최적값: " << res.at("f") << std::endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -1,8 +1,12 @@
 // Rosenbrock problem: https://web.casadi.org/blog/opti/
 
 #include "rosenbrock.h"
+#include "ipopt_recorder.h"
+#include <thread>
+#include <algorithm>
 
-int main() {
+// Usage: optimizer [n_grid]   (contour grid of n_grid x n_grid points, default 100)
+int main(int argc, char* argv[]) {
     casadi::Opti opti;
     
     casadi::MX x = opti.variable();
@@ -10,22 +14,29 @@ int main() {
     casadi::MX f = pow(1 - x, 2) + pow(y - x * x, 2);
 
     opti.minimize(f);
-    casadi::DM X = casadi::DM::linspace(0, 1.5, 100);
-    casadi::DM Y = casadi::DM::linspace(-0.5, 1.5, 100);
-    auto [XX, YY] = meshgrid(X, Y);
-    casadi::DM ZZ = (1-XX)*(1-XX) + (YY-XX*XX)*(YY-XX*XX);
-    save_contour(XX, YY, ZZ);
+
+    // All results of the run go to one file
+    Mat_writer out("../mfiles/mat/rosenbrock.mat");
+
+    int n_grid = argc > 1 ? std::atoi(argv[1]) : 100;
+    casadi::SX xs = casadi::SX::sym("x");
+    casadi::SX ys = casadi::SX::sym("y");
+    casadi::Function f_fun("f", {xs, ys}, {pow(1 - xs, 2) + pow(ys - xs * xs, 2)});
+    casadi::DM X = casadi::DM::linspace(0, 1.5, n_grid);
+    casadi::DM Y = casadi::DM::linspace(-0.5, 1.5, n_grid);
+    save_contour(out, f_fun, X, Y);
 
     // casadi::MX r = opti.parameter();
     // opti.subject_to(x*x+y*y<=r);
-    // save_constraint_1(casadi::DM(r).scalar());
+    // save_constraint_1(out, casadi::DM(r).scalar());
 
     opti.subject_to(x*x+y*y<=1);
-    // save_constraint_1();
+    // save_constraint_1(out);
     opti.subject_to(y>=x);
-    save_constraint_2();
+    save_constraint_2(out);
     
-    opti.solver("ipopt");
+    Ipopt_recorder recorder(opti.nx(), opti.ng(), opti.np(), "rosenbrock_ipopt.log");
+    opti.solver("ipopt", recorder.options());
 
     // std::vector<double> r_values;
     // std::vector<double> f_values;
@@ -39,54 +50,76 @@ int main() {
     //   f_values.push_back(f_val);
     // }
 
+    recorder.start();
     casadi::OptiSol sol = opti.solve();
+    recorder.finish(sol.stats());
+    recorder.write(out, "ipopt_");
+    recorder.print_summary();
 
     double x_opt = sol.value(x).scalar();
     double y_opt = sol.value(y).scalar();
-    save_optimal_solution(x_opt, y_opt);
+    save_optimal_solution(out, x_opt, y_opt);
 
     return 0;
 }
 
-std::pair<casadi::DM, casadi::DM> meshgrid(const casadi::DM& x, const casadi::DM& y) {
-  int nx = x.size1();
-  int ny = y.size1();
-  casadi::DM X(ny, nx);
-  casadi::DM Y(ny, nx);
-
-  for (int i = 0; i < ny; ++i) {
-    for (int j = 0; j < nx; ++j) {
-      X(i, j) = x(j);
-      Y(i, j) = y(i);
+// Evaluate f(x_j, y_i) on the grid and write it as the ny x nx variable `name`
+//
+// f is mapped over a grid column (x broadcast, y vector) and then over a
+// tile of columns with "thread" parallelization. A tile is a contiguous
+// column-major block of the result and is appended to the file as soon as
+// it is evaluated, so only one tile is ever held in memory.
+void save_grid(Mat_writer& out, const casadi::Function& f, const casadi::DM& x, const casadi::DM& y,
+               const std::string& name, size_t tile_bytes) {
+  casadi::casadi_int nx = x.numel(), ny = y.numel();
+  casadi::casadi_int n_threads = std::max(1u, std::thread::hardware_concurrency());
+  casadi::casadi_int tile_cols = std::max<casadi::casadi_int>(n_threads, tile_bytes / (ny * sizeof(double)));
+  tile_cols = std::min(tile_cols, nx);
+
+  casadi::Function f_col = f.map("f_col", "serial", ny, std::vector<casadi::casadi_int>{0}, std::vector<casadi::casadi_int>{});
+
+  // y is the same for every column of a tile
+  std::vector<double> y_rep(ny * tile_cols);
+  for (casadi::casadi_int j = 0; j < tile_cols; ++j)
+    std::copy(y.ptr(), y.ptr() + ny, y_rep.begin() + j * ny);
+  std::vector<double> tile(ny * tile_cols);
+
+  casadi::Function f_tile;
+  std::vector<const double*> arg;
+  std::vector<double*> res;
+  std::vector<casadi::casadi_int> iw;
+  std::vector<double> w;
+  int mem = 0;
+  for (casadi::casadi_int j0 = 0; j0 < nx; j0 += tile_cols) {
+    casadi::casadi_int k = std::min(tile_cols, nx - j0);
+    if (f_tile.is_null() || f_tile.size2_in(0) != k) {  // first tile and the last, narrower one
+      if (!f_tile.is_null()) f_tile.release(mem);
+      f_tile = f_col.map(k, "thread", std::min(n_threads, k));
+      mem = f_tile.checkout();
+      arg.resize(f_tile.sz_arg());
+      res.resize(f_tile.sz_res());
+      iw.resize(f_tile.sz_iw());
+      w.resize(f_tile.sz_w());
     }
-  }
-  return {X, Y};
-}
+    arg[0] = x.ptr() + j0;
+    arg[1] = y_rep.data();
+    res[0] = tile.data();
+    f_tile(arg.data(), res.data(), iw.data(), w.data(), mem);
 
-void save_dm(const casadi::DM& data, const char* name, mat_t* matfp) {
-  size_t dims[2] = {(size_t)data.size1(), (size_t)data.size2()};
-  matvar_t* matvar = Mat_VarCreate(name, MAT_C_DOUBLE, MAT_T_DOUBLE,
-                                    2, dims, (void*)data.ptr(), 0);
-  if (!matvar) throw std::runtime_error("Failed to create matvar");
-  Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_NONE);
-  Mat_VarFree(matvar);
+    out.append_cols(name, tile.data(), ny, k);
+  }
+  f_tile.release(mem);
 }
 
-void save_contour(const casadi::DM& XX, const casadi::DM& YY, const casadi::DM& ZZ) {
-  mat_t* matfp = Mat_CreateVer("../mfiles/mat/rosenbrock_contour.mat", NULL, MAT_FT_MAT5);
-  if (!matfp) throw std::runtime_error("Failed to create .mat file");
-
-  save_dm(XX, "XX", matfp);
-  save_dm(YY, "YY", matfp);
-  save_dm(ZZ, "ZZ", matfp);
-
-  Mat_Close(matfp);
+// XX (1 x nx) and YY (ny x 1) are the grid vectors; contour(XX, YY, ZZ)
+// accepts them in place of the full meshgrid matrices
+void save_contour(Mat_writer& out, const casadi::Function& f, const casadi::DM& x, const casadi::DM& y) {
+  out.write("XX", x.ptr(), 1, x.numel());
+  out.write("YY", y.ptr(), y.numel(), 1);
+  save_grid(out, f, x, y, "ZZ");
 }
 
-void save_constraint_1(double r) {
-  mat_t* matfp = Mat_CreateVer("../mfiles/mat/rosenbrock_constraint_1.mat", NULL, MAT_FT_MAT5);
-  if (!matfp) throw std::runtime_error("Failed to create .mat file");
-
+void save_constraint_1(Mat_writer& out, double r) {
   int N = 500;
   std::vector<double> circle_x(N), circle_y(N);
   for (int i = 0; i < N; ++i) {
@@ -95,22 +128,11 @@ void save_constraint_1(double r) {
       circle_y[i] = r * std::sin(theta);
   }
 
-  size_t dims1[2] = {1, (size_t)N};
-  matvar_t* var_cx = Mat_VarCreate("circle_x", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims1, circle_x.data(), 0);
-  matvar_t* var_cy = Mat_VarCreate("circle_y", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims1, circle_y.data(), 0);
-  if (!var_cx || !var_cy) throw std::runtime_error("Failed to create matvar");
-  Mat_VarWrite(matfp, var_cx, MAT_COMPRESSION_NONE);
-  Mat_VarWrite(matfp, var_cy, MAT_COMPRESSION_NONE);
-  Mat_VarFree(var_cx);
-  Mat_VarFree(var_cy);
-
-  Mat_Close(matfp);
+  out.write("circle_x", circle_x.data(), 1, N);
+  out.write("circle_y", circle_y.data(), 1, N);
 }
 
-void save_constraint_2() {
-  mat_t* matfp = Mat_CreateVer("../mfiles/mat/rosenbrock_constraint_2.mat", NULL, MAT_FT_MAT5);
-  if (!matfp) throw std::runtime_error("Failed to create .mat file");
-
+void save_constraint_2(Mat_writer& out) {
   int M = 200;
   std::vector<double> line_x(M), line_y(M);
   for (int i = 0; i < M; ++i) {
@@ -118,26 +140,11 @@ void save_constraint_2() {
       line_y[i] = line_x[i];
   }
 
-  size_t dims2[2] = {1, (size_t)M};
-  matvar_t* var_lx = Mat_VarCreate("line_x", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims2, line_x.data(), 0);
-  matvar_t* var_ly = Mat_VarCreate("line_y", MAT_C_DOUBLE, MAT_T_DOUBLE, 2, dims2, line_y.data(), 0);
-  if (!var_lx || !var_ly) throw std::runtime_error("Failed to create matvar");
-  Mat_VarWrite(matfp, var_lx, MAT_COMPRESSION_NONE);
-  Mat_VarWrite(matfp, var_ly, MAT_COMPRESSION_NONE);
-  Mat_VarFree(var_lx);
-  Mat_VarFree(var_ly);
-
-  Mat_Close(matfp);
+  out.write("line_x", line_x.data(), 1, M);
+  out.write("line_y", line_y.data(), 1, M);
 }
 
-void save_optimal_solution( double x_opt, double y_opt) {
-  mat_t* matfp = Mat_CreateVer("../mfiles/mat/rosenbrock_optimal_solution.mat", NULL, MAT_FT_MAT5);
-  if (!matfp) throw std::runtime_error("Failed to create .mat file");
-
-  casadi::DM xopt_dm = casadi::DM(std::vector<std::vector<double>>{{x_opt}});
-  casadi::DM yopt_dm = casadi::DM(std::vector<std::vector<double>>{{y_opt}});
-  save_dm(xopt_dm, "x_opt", matfp);
-  save_dm(yopt_dm, "y_opt", matfp);
-
-  Mat_Close(matfp);
+void save_optimal_solution(Mat_writer& out, double x_opt, double y_opt) {
+  out.write("x_opt", x_opt);
+  out.write("y_opt", y_opt);
 }
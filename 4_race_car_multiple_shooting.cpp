@@ -20,18 +20,16 @@
 
 
 #include <iostream>
-#include <fstream>
-#include <ctime>
+#include <cstdlib>
 #include <casadi/casadi.hpp>
+#include "race_car.h"
+#include "ipopt_recorder.h"
+#include "mat_writer.h"
+#include "sparsity_export.h"
 
 using namespace casadi;
 
-// dx/dt = f(x,u)
-MX f(const MX& x, const MX& u) {
-  return vertcat(x(1), u-x(1));
-}
-
-int main(){
+int main(int argc, char* argv[]){
 
 
   // Car race along a track
@@ -40,84 +38,49 @@ int main(){
   // solved with direct multiple-shooting.
   //
   // For more information see: http://labs.casadi.org/OCP
+  //
+  // Usage: race_car [N] [serial|openmp|thread|inline]
 
-  int N = 100; // number of control intervals
+  int N = argc > 1 ? std::atoi(argv[1]) : 100; // number of control intervals
+  std::string parallelization = argc > 2 ? argv[2] : "serial";
 
   auto opti = casadi::Opti(); // Optimization problem
 
   Slice all;
-  // ---- decision variables ---------
-  auto X = opti.variable(2,N+1); // state trajectory
+  // RK4 steps are one rk4 Function mapped over the horizon (see race_car.cpp)
+  Race_car_ocp ocp = race_car_ocp(opti, N, parallelization);
+  auto X = ocp.X;
   auto pos   = X(0,all);
   auto speed = X(1,all);
-  auto U = opti.variable(1,N);   // control trajectory (throttle)
-  auto T = opti.variable();      // final time
-
-  // ---- objective          ---------
-  opti.minimize(T); // race in minimal time
-
-  // ---- dynamic constraints --------
-  auto dt = T/N;
-  for (int k=0;k<N;++k) {
-    auto k1 = f(X(all,k),         U(all,k));
-    auto k2 = f(X(all,k)+dt/2*k1, U(all,k));
-    auto k3 = f(X(all,k)+dt/2*k2, U(all,k));
-    auto k4 = f(X(all,k)+dt*k3,   U(all,k));
-    auto x_next = X(all,k) + dt/6*(k1+2*k2+2*k3+k4);
-    opti.subject_to(X(all,k+1)==x_next); // close the gaps 
-  }
-
-  // ---- path constraints -----------
-  opti.subject_to(speed<=1-sin(2*pi*pos)/2); // track speed limit
-  opti.subject_to(0<=U<=1);           // control is limited
-
-  // ---- boundary conditions --------
-  opti.subject_to(pos(0)==0);   // start at position 0 ...
-  opti.subject_to(speed(0)==0); // ... from stand-still 
-  opti.subject_to(pos(N)==1); // finish line at position 1
-
-  // ---- misc. constraints  ----------
-  opti.subject_to(T>=0); // Time must be positive
-
-  // ---- initial values for solver ---
-  opti.set_initial(speed, 1);
-  opti.set_initial(T, 1);
+  auto U = ocp.U;
+  auto T = ocp.T;
 
   // ---- solve NLP              ------
-  opti.solver("ipopt"); // set numerical backend
+  // Ipopt stays quiet; its iterations go to race_car_ipopt.mat instead
+  Ipopt_recorder recorder(opti.nx(), opti.ng(), opti.np(), "race_car_ipopt.log");
+  opti.solver("ipopt", recorder.options()); // set numerical backend
+  recorder.start();
   auto sol = opti.solve();   // actual solve
-
-  // Create Matlab script to plot the solution
-  std::ofstream file;
-  std::string filename = "race_car_results.m";
-  file.open(filename.c_str());
-  file << "% Results file from " __FILE__ << std::endl;
-  file << "% Generated " __DATE__ " at " __TIME__ << std::endl;
-  file << std::endl;
-  
-  // Save results to file
-  file << "t = linspace(0," << sol.value(T) << "," << N << "+1);"<< std::endl;
-  file << "speed = " << std::vector<double>(sol.value(speed)) << ";" << std::endl;
-  file << "pos = " << std::vector<double>(sol.value(pos)) << ";" << std::endl;
-  file << "U = " << std::vector<double>(sol.value(U)) << ";" << std::endl;
-
-  file << "figure;" << std::endl;
-  file << "hold on;" << std::endl;
-  file << "plot(t,speed);" << std::endl;
-  file << "plot(t,pos);" << std::endl;
-  file << "plot(t,1-sin(2*pi*pos)/2,'r--');" << std::endl;
-  file << "stairs(t(1:end-1),U,'k');" << std::endl;
-  file << "xlabel('Time [s]');" << std::endl;
-  file << "legend('speed','pos','speed limit','throttle','Location','northwest');" << std::endl;
-
-  // Have a look at the constraint Jacobian
-  jacobian(opti.g(), opti.x()).sparsity().spy_matlab("race_car_jac_g.m");
-  
-  file << "figure" << std::endl;
-  file << "race_car_jac_g;" << std::endl;
-  file << "xlabel('decision variables');" << std::endl;
-  file << "ylabel('constraints');" << std::endl;
-  file << "print('jac_sp','-dpng');" << std::endl;
+  recorder.finish(sol.stats());
+  recorder.save_mat("race_car_ipopt.mat");
+  recorder.print_summary();
+
+  // Save the solution; mfiles/race_car_plot.m loads and plots it
+  Mat_writer out("race_car_results.mat");
+  DM t = DM::linspace(0, sol.value(T).scalar(), N+1);
+  out.write("t", t.ptr(), 1, N+1);
+  out.write("pos", sol.value(pos));
+  out.write("speed", sol.value(speed));
+  out.write("U", sol.value(U));
+  out.write("T", sol.value(T).scalar());
+  out.write("lam_g", sol.value(opti.lam_g()));
+
+  // Have a look at the constraint Jacobian: pattern only, as index arrays
+  // plus a density image, so large N stays small on disk
+  Sparsity jac_sp = jac_g_sparsity(opti);
+  Mat_writer jac_out("race_car_jac_g.mat");
+  save_sparsity(jac_out, jac_sp);
+  print_sparsity_stats(sparsity_stats(jac_sp));
 
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,176 @@
+// Receding-horizon MPC for the race car OCP of 4_race_car_multiple_shooting.cpp
+//
+// The multiple-shooting NLP is built once with the initial state as a
+// parameter. Every control period it is re-solved from the measured state,
+// warm-started (primal and dual) from the previous solution shifted by one
+// interval. The track is periodic, so the finish line is always one lap
+// ahead of the current position and the position is wrapped after each lap.
+//
+// The closed-loop trajectory is appended to race_car_mpc.mat in blocks of
+// rows while the loop runs; mfiles/race_car_plot.m plots it. With "append"
+// the rows continue an existing log instead of replacing it.
+//
+// Usage: race_car_mpc [n_steps] [output.mat] [append]
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <casadi/casadi.hpp>
+#include "race_car.h"
+#include "mat_writer.h"
+#include "bench_util.h"
+
+using namespace casadi;
+
+class Race_car_mpc {
+public:
+  explicit Race_car_mpc(int N) : N(N) {
+    X0 = opti.parameter(2); // measured state
+    ocp = race_car_ocp(opti, N, "serial", X0);
+
+    Dict opts;
+    opts["print_time"] = false;
+    opts["ipopt.print_level"] = 0;
+    opts["ipopt.sb"] = "yes";
+    opts["ipopt.warm_start_init_point"] = "yes";
+    opti.solver("ipopt", opts);
+  }
+
+  /**
+   * @brief Solve from the measured state and return the first control
+   */
+  double solve(const DM& x0) {
+    opti.set_value(X0, x0);
+    OptiSol sol = opti.solve_limited();
+
+    X_sol = sol.value(ocp.X);
+    U_sol = sol.value(ocp.U);
+    T_sol = sol.value(ocp.T).scalar();
+    lam_dyn = sol.value(opti.dual(ocp.con_dyn));
+    lam_speed = sol.value(opti.dual(ocp.con_speed));
+    lam_u = sol.value(opti.dual(ocp.con_u));
+    lam_x0 = sol.value(opti.dual(ocp.con_x0));
+    lam_end = sol.value(opti.dual(ocp.con_end));
+    lam_T = sol.value(opti.dual(ocp.con_T));
+    success = sol.stats().at("success").as_bool();
+
+    return U_sol.nonzeros().at(0);
+  }
+
+  /**
+   * @brief Initialize the next solve with the last solution shifted by one interval
+   * @param pos_offset Amount subtracted from the position after a lap wrap
+   */
+  void warm_start(double pos_offset) {
+    DM X_init = shift_columns(X_sol);
+    DM pos_init = X_init(0, Slice());
+    X_init(0, Slice()) = pos_init - pos_offset;
+
+    opti.set_initial(ocp.X, X_init);
+    opti.set_initial(ocp.U, shift_columns(U_sol));
+    opti.set_initial(ocp.T, T_sol);
+
+    opti.set_initial(opti.dual(ocp.con_dyn), shift_columns(lam_dyn));
+    opti.set_initial(opti.dual(ocp.con_speed), shift_columns(lam_speed));
+    opti.set_initial(opti.dual(ocp.con_u), shift_columns(lam_u));
+    opti.set_initial(opti.dual(ocp.con_x0), lam_x0);
+    opti.set_initial(opti.dual(ocp.con_end), lam_end);
+    opti.set_initial(opti.dual(ocp.con_T), lam_T);
+  }
+
+  /**
+   * @brief Length of the first control interval of the last solution
+   */
+  double dt() const { return T_sol / N; }
+
+  /**
+   * @brief Predicted lap time and multipliers of the initial-state constraint
+   */
+  double lap_time() const { return T_sol; }
+  const DM& x0_multipliers() const { return lam_x0; }
+
+  bool success = false;
+
+private:
+  int N;
+  Opti opti;
+  MX X0;
+  Race_car_ocp ocp;
+
+  DM X_sol, U_sol;
+  double T_sol = 1;
+  DM lam_dyn, lam_speed, lam_u, lam_x0, lam_end, lam_T;
+};
+
+int main(int argc, char* argv[]) {
+  int N = 100;                                    // number of control intervals
+  int n_steps = argc > 1 ? std::atoi(argv[1]) : 2000; // closed-loop steps
+  std::string filename = argc > 2 ? argv[2] : "race_car_mpc.mat";
+  bool append = argc > 3 && std::string(argv[3]) == "append";
+
+  // Plant model: the same RK4 step, integrated with the applied throttle
+  Function plant = race_car_rk4();
+
+  // Baseline: build the NLP and solve it cold, as 4_race_car_multiple_shooting does
+  auto tic = std::chrono::high_resolution_clock::now();
+  {
+    Race_car_mpc cold(N);
+    cold.solve(DM(std::vector<double>{0, 0}));
+  }
+  auto toc = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> cold_time = toc - tic;
+
+  Race_car_mpc mpc(N);
+  std::vector<double> x_k = {0, 0}; // start at position 0 from stand-still
+  std::vector<double> latency;
+  latency.reserve(n_steps);
+  int laps = 0, failures = 0;
+
+  // Closed-loop log, one row per step, appended every flush_rows steps
+  Mat_writer out(filename, false, MAT_FT_MAT73, append);
+  const int flush_rows = 200;
+  // pos is unwrapped (laps added), T is the predicted lap time
+  const std::vector<std::string> names = {"t", "pos", "speed", "U", "T", "lam_x0_pos", "lam_x0_speed",
+                                          "latency", "success"};
+  std::vector<std::vector<double>> rows(names.size());
+  double t_k = 0;
+
+  for (int k = 0; k < n_steps; ++k) {
+    tic = std::chrono::high_resolution_clock::now();
+    double u_k = mpc.solve(x_k);
+    toc = std::chrono::high_resolution_clock::now();
+    latency.push_back(std::chrono::duration<double>(toc - tic).count());
+    failures += !mpc.success;
+
+    std::vector<double> lam_x0 = mpc.x0_multipliers().nonzeros();
+    double row[] = {t_k, x_k[0] + laps, x_k[1], u_k, mpc.lap_time(), lam_x0.at(0), lam_x0.at(1),
+                    latency.back(), double(mpc.success)};
+    for (size_t i = 0; i < names.size(); ++i) rows[i].push_back(row[i]);
+    if ((int)rows[0].size() == flush_rows || k + 1 == n_steps) {
+      for (size_t i = 0; i < names.size(); ++i)
+        out.append_rows(names[i], rows[i].data(), rows[i].size(), 1);
+      for (auto& r : rows) r.clear();
+    }
+    t_k += mpc.dt();
+
+    x_k = std::vector<double>(plant(std::vector<DM>{x_k, u_k, mpc.dt()})[0]);
+
+    double offset = 0;
+    if (x_k[0] >= 1) {
+      offset = 1;
+      x_k[0] -= 1;
+      laps++;
+    }
+    mpc.warm_start(offset);
+  }
+
+  std::cout << "cold build + solve: " << cold_time.count() << " s" << std::endl;
+  std::cout << "closed-loop steps: " << n_steps << ", laps: " << laps
+            << ", failed solves: " << failures << std::endl;
+  std::cout << "warm solve latency p50: " << percentile(latency, 0.50) << " s"
+            << ", p99: " << percentile(latency, 0.99) << " s"
+            << ", max: " << percentile(latency, 1.0) << " s" << std::endl;
+  std::cout << "closed-loop log written to " << filename << std::endl;
+
+  return 0;
+}
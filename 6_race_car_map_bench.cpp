@@ -0,0 +1,65 @@
+// Race car OCP: graph build, NLP callback and Ipopt time versus horizon and
+// map parallelization mode.
+//
+// Usage: race_car_map_bench [N_1 N_2 ...]   (default 100 1000 10000)
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <casadi/casadi.hpp>
+#include "race_car.h"
+
+using namespace casadi;
+
+int main(int argc, char* argv[]) {
+  std::vector<int> horizons = {100, 1000, 10000};
+  if (argc > 1) {
+    horizons.clear();
+    for (int i = 1; i < argc; ++i) horizons.push_back(std::atoi(argv[i]));
+  }
+  std::vector<std::string> modes = {"inline", "serial", "openmp", "thread"};
+
+  Dict opts;
+  opts["print_time"] = false;
+  opts["ipopt.print_level"] = 0;
+  opts["ipopt.sb"] = "yes";
+
+  std::cout << std::setw(7) << "N" << std::setw(9) << "mode"
+            << std::setw(12) << "build[s]" << std::setw(12) << "setup[s]"
+            << std::setw(12) << "nlp_cb[s]" << std::setw(12) << "ipopt[s]"
+            << std::setw(7) << "iter" << std::setw(12) << "T*" << std::endl;
+
+  for (int N : horizons) {
+    for (const std::string& mode : modes) {
+      auto tic = std::chrono::high_resolution_clock::now();
+      Opti opti;
+      Race_car_ocp ocp = race_car_ocp(opti, N, mode);
+      auto toc = std::chrono::high_resolution_clock::now();
+      std::chrono::duration<double> build = toc - tic;
+
+      tic = std::chrono::high_resolution_clock::now();
+      opti.solver("ipopt", opts);
+      OptiSol sol = opti.solve_limited();
+      toc = std::chrono::high_resolution_clock::now();
+      std::chrono::duration<double> solve = toc - tic;
+
+      // t_wall_nlp_* are the NLP callback timings, t_wall_total the Ipopt wall time
+      Dict stats = sol.stats();
+      double t_callbacks = 0;
+      for (const auto& s : stats)
+        if (s.first.rfind("t_wall_nlp_", 0) == 0) t_callbacks += s.second.as_double();
+      double t_ipopt = stats.at("t_wall_total").as_double();
+
+      std::cout << std::setw(7) << N << std::setw(9) << mode
+                << std::setw(12) << build.count()
+                << std::setw(12) << solve.count() - t_ipopt
+                << std::setw(12) << t_callbacks
+                << std::setw(12) << t_ipopt
+                << std::setw(7) << stats.at("iter_count").as_int()
+                << std::setw(12) << sol.value(ocp.T).scalar() << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,77 @@
+// Setup, first-call and solve time of the NLP of "2_test_largeProb copy.cpp"
+// for the scalar-loop MX graph and the vectorized MX and SX graphs.
+//
+// Usage: large_prob_bench [N_1 N_2 ...]   (default 500 ... 100000)
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <casadi/casadi.hpp>
+#include "large_prob.h"
+#include "bench_util.h"
+
+using namespace casadi;
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes = {500, 1000, 5000, 10000, 50000, 100000};
+    if (argc > 1) {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+    }
+    // The scalar loop builds an O(N)-deep graph; skip it beyond this size
+    const int loop_max_N = 10000;
+
+    Dict opts;
+    opts["ipopt.max_iter"] = 10000; 
+    opts["ipopt.tol"] = 1e-10;
+    opts["ipopt.print_level"] = 0;
+    opts["ipopt.sb"] = "yes";
+    opts["print_time"] = false;
+
+    std::cout << std::setw(8) << "N" << std::setw(7) << "graph"
+              << std::setw(12) << "build[s]" << std::setw(12) << "setup[s]"
+              << std::setw(12) << "first[s]" << std::setw(12) << "solve[s]"
+              << std::setw(7) << "iter" << std::endl;
+
+    for (int N : sizes) {
+        for (std::string mode : {"loop", "mx", "sx"}) {
+            if (mode == "loop" && N > loop_max_N) continue;
+
+            // build: expression graph, setup: nlpsol construction
+            auto tic = bench_clock::now();
+            MXDict nlp_mx;
+            SXDict nlp_sx;
+            if (mode == "sx") nlp_sx = large_prob_nlp<SX>(N);
+            else nlp_mx = large_prob_nlp<MX>(N, mode == "mx");
+            double t_build = seconds_since(tic);
+
+            tic = bench_clock::now();
+            Function solver = mode == "sx"
+                ? nlpsol("solver", "ipopt", nlp_sx, opts)
+                : nlpsol("solver", "ipopt", nlp_mx, opts);
+            double t_setup = seconds_since(tic);
+
+            DMDict arg;
+            arg["x0"] = DM::zeros(N);
+            arg["lbg"] = DM::zeros(N-1);
+            arg["ubg"] = DM::zeros(N-1);
+
+            // first: first call including lazy initialization, solve: repeated call
+            tic = bench_clock::now();
+            solver(arg);
+            double t_first = seconds_since(tic);
+
+            tic = bench_clock::now();
+            solver(arg);
+            double t_solve = seconds_since(tic);
+
+            std::cout << std::setw(8) << N << std::setw(7) << mode
+                      << std::setw(12) << t_build << std::setw(12) << t_setup
+                      << std::setw(12) << t_first << std::setw(12) << t_solve
+                      << std::setw(7) << solver.stats().at("iter_count").as_int() << std::endl;
+        }
+    }
+
+    return 0;
+}
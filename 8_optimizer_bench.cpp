@@ -0,0 +1,182 @@
+// Benchmark of the three solvers of this repo on the problem of 1_cmp_pgd_ex.cpp
+//
+//   min  15*(x1^2-1)^2 + (x2^2-2)^2 + 4*x1*x2 + x1 + x2
+//   s.t. x1^2 + (x2-1.2)^2 <= 0.5^2
+//
+// Ipopt (nlpsol), the Eigen PGD (PGD_example/pgd.hpp) and the codegen PGD
+// (PGD_API_s) solve the same random start set after a warmup; per-solve
+// times, iterations and function evaluations are summarized and written
+// to a JSON file.
+//
+// Usage: bench [n_starts] [n_rep] [output.json]
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <casadi/casadi.hpp>
+#include "casadi_api_a_test/casadi_api_a_test.hpp"
+#include "PGD_example/pgd.hpp"
+#include "PGD_example/pgd_problems.hpp"
+#include "bench_util.h"
+
+struct Solve_record {
+    double time, f;
+    int iter, n_f, n_grad;
+};
+
+struct Backend_result {
+    std::string name;
+    double setup_time = 0;
+    std::vector<Solve_record> solves;
+};
+
+static double mean_of(const std::vector<Solve_record>& s, double Solve_record::*field) {
+    double sum = 0;
+    for (const auto& r : s) sum += r.*field;
+    return sum / s.size();
+}
+
+static double mean_of(const std::vector<Solve_record>& s, int Solve_record::*field) {
+    double sum = 0;
+    for (const auto& r : s) sum += r.*field;
+    return sum / s.size();
+}
+
+// Time solve(start) n_rep times per start after n_warmup untimed solves
+template <class Solve>
+void run_backend(Backend_result& out, const std::vector<Eigen::Vector2d>& starts,
+                 int n_warmup, int n_rep, Solve&& solve) {
+    for (int w = 0; w < n_warmup; w++) solve(starts[w % starts.size()]);
+    for (const auto& X0 : starts) {
+        for (int rep = 0; rep < n_rep; rep++) {
+            auto tic = bench_clock::now();
+            Solve_record r = solve(X0);
+            r.time = seconds_since(tic);
+            out.solves.push_back(r);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int n_starts = argc > 1 ? std::atoi(argv[1]) : 200;
+    int n_rep = argc > 2 ? std::atoi(argv[2]) : 10;
+    std::string json_file = argc > 3 ? argv[3] : "bench_results.json";
+    const int n_warmup = 20;
+
+    // Random start set, identical for every backend
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+    std::vector<Eigen::Vector2d> starts(n_starts);
+    for (auto& X0 : starts) X0 = Eigen::Vector2d(dist(gen), dist(gen));
+
+    std::vector<Backend_result> results(3);
+
+    // ---- Ipopt ----
+    {
+        Backend_result& res = results[0];
+        res.name = "ipopt";
+        casadi::MX x = casadi::MX::sym("x", 2);
+        casadi::MX f = 15.0*pow(x(0)*x(0)-1, 2) + 1.0*pow(x(1)*x(1) - 2, 2) + 4.0*x(0)*x(1) + x(0) + x(1);
+        casadi::MX g = pow(x(0), 2) + pow(x(1) - 1.2, 2);
+
+        casadi::Dict opts;
+        opts["ipopt.tol"] = 1e-4;
+        opts["ipopt.print_level"] = 0;
+        opts["ipopt.sb"] = "yes";
+        opts["print_time"] = false;
+
+        auto tic = bench_clock::now();
+        casadi::Function solver = casadi::nlpsol("solver", "ipopt", casadi::MXDict{{"x", x}, {"f", f}, {"g", g}}, opts);
+        res.setup_time = seconds_since(tic);
+
+        casadi::DMDict arg;
+        arg["lbg"] = -casadi::inf;
+        arg["ubg"] = 0.5*0.5;
+        run_backend(res, starts, n_warmup, n_rep, [&](const Eigen::Vector2d& X0) {
+            arg["x0"] = casadi::DM(std::vector<double>{X0(0), X0(1)});
+            casadi::DMDict sol = solver(arg);
+            const casadi::Dict& stats = solver.stats();
+            return Solve_record{0, sol.at("f").scalar(),
+                                static_cast<int>(stats.at("iter_count").as_int()),
+                                static_cast<int>(stats.at("n_call_nlp_f").as_int()),
+                                static_cast<int>(stats.at("n_call_nlp_grad_f").as_int())};
+        });
+    }
+
+    // ---- Eigen PGD ----
+    {
+        Backend_result& res = results[1];
+        res.name = "pgd_eigen";
+        Quartic_problem problem;
+        auto tic = bench_clock::now();
+        PGD<2, Quartic_problem> solver(problem);
+        res.setup_time = seconds_since(tic);
+
+        run_backend(res, starts, n_warmup, n_rep, [&](const Eigen::Vector2d& X0) {
+            solver.solve(X0);
+            return Solve_record{0, solver.objective(), solver.iterations(),
+                                solver.obj_evals(), solver.grad_evals()};
+        });
+    }
+
+    // ---- codegen PGD ----
+    {
+        Backend_result& res = results[2];
+        res.name = "pgd_codegen";
+        auto tic = bench_clock::now();
+        PGD_API_s solver;
+        res.setup_time = seconds_since(tic);
+
+        run_backend(res, starts, n_warmup, n_rep, [&](const Eigen::Vector2d& X0) {
+            solver.solve(X0);
+            return Solve_record{0, solver.objective(), solver.iterations(),
+                                solver.obj_evals(), solver.grad_evals()};
+        });
+    }
+
+    // ---- report ----
+    std::ofstream json(json_file);
+    json << std::setprecision(9);
+    json << "{\n  \"n_starts\": " << n_starts << ", \"n_rep\": " << n_rep
+         << ", \"n_warmup\": " << n_warmup << ",\n  \"backends\": [\n";
+
+    std::cout << std::setw(12) << "backend" << std::setw(12) << "setup[s]"
+              << std::setw(12) << "p50[s]" << std::setw(12) << "p90[s]" << std::setw(12) << "p99[s]"
+              << std::setw(8) << "iter" << std::setw(8) << "f_eval" << std::setw(8) << "g_eval"
+              << std::setw(12) << "best f" << std::endl;
+
+    for (size_t b = 0; b < results.size(); b++) {
+        const Backend_result& res = results[b];
+        std::vector<double> t;
+        for (const auto& r : res.solves) t.push_back(r.time);
+        double best_f = 1e300;
+        for (const auto& r : res.solves) best_f = std::min(best_f, r.f);
+
+        double p50 = percentile(t, 0.50), p90 = percentile(t, 0.90), p99 = percentile(t, 0.99);
+        double iter = mean_of(res.solves, &Solve_record::iter);
+        double n_f = mean_of(res.solves, &Solve_record::n_f);
+        double n_grad = mean_of(res.solves, &Solve_record::n_grad);
+
+        std::cout << std::setw(12) << res.name << std::setw(12) << res.setup_time
+                  << std::setw(12) << p50 << std::setw(12) << p90 << std::setw(12) << p99
+                  << std::setw(8) << iter << std::setw(8) << n_f << std::setw(8) << n_grad
+                  << std::setw(12) << best_f << std::endl;
+
+        json << "    {\"name\": \"" << res.name << "\", \"setup\": " << res.setup_time
+             << ", \"solves\": " << res.solves.size()
+             << ", \"time\": {\"mean\": " << mean_of(res.solves, &Solve_record::time)
+             << ", \"min\": " << percentile(t, 0.0) << ", \"p50\": " << p50
+             << ", \"p90\": " << p90 << ", \"p99\": " << p99 << ", \"max\": " << percentile(t, 1.0)
+             << "}, \"iter\": " << iter << ", \"f_evals\": " << n_f << ", \"grad_evals\": " << n_grad
+             << ", \"best_f\": " << best_f << "}" << (b + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+    std::cout << "results written to " << json_file << std::endl;
+
+    return 0;
+}
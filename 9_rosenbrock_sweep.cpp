@@ -0,0 +1,132 @@
+// Parametric sweep of the Rosenbrock problem of 3_rosenbrock.cpp over the
+// constraint radius r:
+//
+//   min  (1-x)^2 + (y-x^2)^2   s.t.  x^2 + y^2 <= r,  y >= x
+//
+// The NLP with r as parameter is built once. The r grid is split into one
+// contiguous block per worker thread, each with its own Ipopt instance;
+// inside a block every solve is warm-started (primal and dual) from its
+// grid neighbour. Finished results are appended to a MAT 7.3 file in
+// blocks while the sweep runs. The Opti loop of 3_rosenbrock.cpp
+// (set_value + solve per point) is timed as the sequential baseline.
+//
+// Usage: rosenbrock_sweep [n_points] [n_threads] [output.mat]
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+#include <casadi/casadi.hpp>
+#include "mat_writer.h"
+#include "bench_util.h"
+
+// Solve r[begin, end) in order, each point warm-started from the previous one
+static void sweep_block(casadi::Function solver, const std::vector<double>& r,
+                        size_t begin, size_t end, Mat_writer& writer, size_t flush_rows) {
+  static const std::vector<const char*> names = {"r", "f", "x", "y", "status"};
+  // Keeps the rows of one block together in all five variables
+  static std::mutex block_mutex;
+  std::vector<std::vector<double>> rows(names.size());
+
+  casadi::DMDict arg;
+  arg["x0"] = casadi::DM(std::vector<double>{0.0, 0.0});
+  arg["lbg"] = casadi::DM(std::vector<double>{-casadi::inf, 0});
+  arg["ubg"] = casadi::DM(std::vector<double>{0, casadi::inf});
+
+  for (size_t i = begin; i < end; i++) {
+    arg["p"] = r[i];
+    casadi::DMDict res = solver(arg);
+    bool success = solver.stats().at("success").as_bool();
+
+    if (success) {
+      arg["x0"] = res.at("x");
+      arg["lam_x0"] = res.at("lam_x");
+      arg["lam_g0"] = res.at("lam_g");
+    }
+
+    std::vector<double> x = res.at("x").nonzeros();
+    double row[] = {r[i], res.at("f").scalar(), x[0], x[1], double(success)};
+    for (size_t k = 0; k < names.size(); k++) rows[k].push_back(row[k]);
+
+    if (rows[0].size() == flush_rows || i + 1 == end) {
+      std::lock_guard<std::mutex> lock(block_mutex);
+      for (size_t k = 0; k < names.size(); k++)
+        writer.append_rows(names[k], rows[k].data(), rows[k].size(), 1);
+      for (auto& c : rows) c.clear();
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  size_t n_points = argc > 1 ? std::atol(argv[1]) : 20000;
+  unsigned n_threads = argc > 2 ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+  std::string filename = argc > 3 ? argv[3] : "../mfiles/mat/rosenbrock_sweep.mat";
+  const size_t n_baseline = std::min<size_t>(n_points, 1000);
+  const size_t flush_rows = 256;
+
+  std::vector<double> r(n_points);
+  for (size_t i = 0; i < n_points; i++) r[i] = 1.0 + 2.0 * i / std::max<size_t>(n_points - 1, 1);
+
+  casadi::Dict opts;
+  opts["print_time"] = false;
+  opts["ipopt.print_level"] = 0;
+  opts["ipopt.sb"] = "yes";
+
+  // ---- sequential baseline: the Opti loop of 3_rosenbrock.cpp ----
+  double t_seq;
+  {
+    casadi::Opti opti;
+    casadi::MX x = opti.variable();
+    casadi::MX y = opti.variable();
+    casadi::MX p = opti.parameter();
+    opti.minimize(pow(1 - x, 2) + pow(y - x * x, 2));
+    opti.subject_to(x*x+y*y<=p);
+    opti.subject_to(y>=x);
+    opti.solver("ipopt", opts);
+
+    auto tic = bench_clock::now();
+    for (size_t i = 0; i < n_baseline; i++) {
+      opti.set_value(p, r[i * n_points / n_baseline]);
+      opti.solve_limited();
+    }
+    t_seq = seconds_since(tic);
+  }
+
+  // ---- parametric NLP, built once ----
+  casadi::MX z = casadi::MX::sym("z", 2);
+  casadi::MX p = casadi::MX::sym("p");
+  casadi::MX f = pow(1 - z(0), 2) + pow(z(1) - z(0) * z(0), 2);
+  casadi::MX g = vertcat(z(0)*z(0) + z(1)*z(1) - p, z(1) - z(0));
+  casadi::Function nlp("nlp", {z, p}, {f, g}, {"x", "p"}, {"f", "g"});
+
+  // One solver instance per worker, created here since plugin loading is not thread-safe
+  casadi::Dict warm_opts = opts;
+  warm_opts["ipopt.warm_start_init_point"] = "yes";
+  std::vector<casadi::Function> solvers;
+  for (unsigned w = 0; w < n_threads; w++)
+    solvers.push_back(casadi::nlpsol("solver_" + std::to_string(w), "ipopt", nlp, warm_opts));
+
+  // ---- parallel sweep ----
+  double t_par;
+  {
+    Mat_writer writer(filename);
+    auto tic = bench_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < n_threads; w++)
+      workers.emplace_back(sweep_block, solvers[w], std::cref(r),
+                           w * n_points / n_threads, (w + 1) * n_points / n_threads,
+                           std::ref(writer), flush_rows);
+    for (auto& t : workers) t.join();
+    t_par = seconds_since(tic);
+  }
+
+  std::cout << "sequential Opti loop: " << n_baseline << " solves, "
+            << n_baseline / t_seq << " solves/s" << std::endl;
+  std::cout << "parallel sweep      : " << n_points << " solves on " << n_threads << " threads, "
+            << n_points / t_par << " solves/s (x" << (n_points / t_par) / (n_baseline / t_seq) << ")" << std::endl;
+  std::cout << "results written to " << filename << std::endl;
+
+  return 0;
+}
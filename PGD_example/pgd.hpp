@@ -0,0 +1,275 @@
+#ifndef PGD_HPP
+#define PGD_HPP
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <Eigen/Dense>
+
+/**
+ * @brief Acceleration applied between PGD iterations
+ *
+ * nesterov:         fixed Nesterov momentum tk (the original scheme)
+ * restart_function: Nesterov, momentum reset when the objective increases
+ * restart_gradient: Nesterov, momentum reset when the step (Y - X) points
+ *                   against the last move (X - X_prev)
+ * anderson:         type-II Anderson acceleration of the projected gradient
+ *                   fixed-point map with the last anderson_memory iterates
+ */
+enum class PGD_acceleration { nesterov, restart_function, restart_gradient, anderson };
+
+/**
+ * @brief Parameters of the nonmonotone accelerated PGD
+ */
+struct PGD_options {
+    double eta = 0.4;        // weight of the nonmonotone reference ck
+    double del = 0.001;      // sufficient decrease constant
+    double rho = 0.5;        // backtracking factor
+    double tol = 1e-6;       // exit when (ck_plus - ck)^2 < tol
+    double res_tol = 0;      // if > 0, also exit when ||x - P(x - grad f(x))||_inf < res_tol,
+                             // at one more gradient per iteration
+    int max_iter = 100;
+    int max_back_iter = 10;
+    PGD_acceleration acceleration = PGD_acceleration::nesterov;
+    int anderson_memory = 3; // at most PGD_max_anderson_memory
+};
+
+constexpr int PGD_max_anderson_memory = 8;
+
+/**
+ * @brief Nonmonotone accelerated projected gradient descent in N dimensions
+ *
+ * Same algorithm as Projected_GD in PGD_example.cpp (BB step sizes,
+ * Nesterov momentum and a nonmonotone reference value ck), written once for
+ * every problem size. With a compile-time N all vectors are fixed-size Eigen
+ * types, so the element loops are unrolled and nothing touches the heap.
+ * With N = Eigen::Dynamic the vectors are allocated once in the constructor
+ * and every update is a vectorized Eigen expression evaluated in place.
+ *
+ * Problem must provide
+ *   double objective(const Vec& x);
+ *   void gradient(const Vec& x, Vec& g);
+ *   void project(const Vec& x, Vec& z);
+ */
+template <int N, class Problem>
+class PGD {
+public:
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    /**
+     * @brief Constructor
+     * @param problem Objective, gradient and projection
+     * @param n Problem size, only used when N is Eigen::Dynamic
+     * @param opts Algorithm parameters
+     */
+    PGD(Problem& problem, int n = N, const PGD_options& opts = PGD_options())
+        : problem(problem), opts(opts) {
+        for (Vec* v : {&X, &Y, &Z, &V, &T, &X_prev, &Y_prev, &grad_X, &grad_Y, &grad_Y_prev})
+            v->resize(n);
+        if (opts.acceleration == PGD_acceleration::anderson) {
+            m = std::max(1, std::min(opts.anderson_memory, PGD_max_anderson_memory));
+            dF.resize(n, m);
+            dG.resize(n, m);
+            F_prev.resize(n);
+            G_prev.resize(n);
+        }
+    }
+
+    /**
+     * @brief Solve from X_init; the result is available through X()
+     */
+    void solve(const Vec& X_init) {
+        X = X_init;
+        Y = X;
+        X_prev = X;
+        Y_prev.setZero();
+        grad_Y_prev.setZero();
+
+        FX = problem.objective(X);
+
+        double tk = 1, qk = 1, ck = FX;
+        iter = 0;
+        n_obj = 1; n_grad = 0;
+        n_hist = 0;
+        res_prev = std::numeric_limits<double>::infinity();
+        double FX_prev = FX;
+        alpha_last = 1;
+
+        while (true) {
+            iter++;
+
+            problem.gradient(Y, grad_Y); n_grad++;
+            double alpha_Y = bb_step(Y, grad_Y);
+
+            bool accepted_Z = line_search(Y, grad_Y, alpha_Y, ck, Z, FZ);
+            if (accepted_Z) {
+                X = Z;
+                FX = FZ;
+            } else {
+                problem.gradient(X, grad_X); n_grad++;
+                double alpha_X = bb_step(X, grad_X);
+                line_search(X, grad_X, alpha_X, ck, V, FV);
+
+                if (FZ <= FV) {
+                    X = Z;
+                    FX = FZ;
+                } else {
+                    X = V;
+                    FX = FV;
+                }
+            }
+
+            double tk_plus = (1 + std::sqrt(1 + 4 * tk * tk)) / 2.0;
+            double qk_plus = opts.eta * qk + 1;
+            double ck_plus = (opts.eta * qk * ck + FX) / qk_plus;
+
+            if ((ck_plus - ck) * (ck_plus - ck) < opts.tol || iter >= opts.max_iter)
+                break;
+            if (opts.res_tol > 0 && residual() < opts.res_tol)
+                break;
+
+            Y_prev = Y;
+            grad_Y_prev = grad_Y;
+
+            bool restart = false;
+            switch (opts.acceleration) {
+            case PGD_acceleration::nesterov:
+                break;
+            case PGD_acceleration::restart_function:
+                restart = FX > FX_prev;
+                break;
+            case PGD_acceleration::restart_gradient:
+                restart = (Y_prev - X).dot(X - X_prev) > 0;
+                break;
+            case PGD_acceleration::anderson:
+                anderson_step();
+                break;
+            }
+
+            if (restart) {
+                // Drop the momentum and continue from X
+                Y = X;
+                tk_plus = 1;
+            } else if (opts.acceleration != PGD_acceleration::anderson) {
+                // Nesterov step update
+                Y.noalias() = X + tk / tk_plus * (Z - X) + (tk - 1) / tk_plus * (X - X_prev);
+            }
+
+            X_prev = X;
+            FX_prev = FX;
+            tk = tk_plus;
+            qk = qk_plus;
+            ck = ck_plus;
+        }
+    }
+
+    const Vec& solution() const { return X; }
+    double objective() const { return FX; }
+    int iterations() const { return iter; }
+    int obj_evals() const { return n_obj; }
+    int grad_evals() const { return n_grad; }
+
+private:
+    /**
+     * @brief Projected-gradient residual ||X - P(X - grad f(X))||_inf, in grad_X and V
+     */
+    double residual() {
+        problem.gradient(X, grad_X); n_grad++;
+        T.noalias() = X - grad_X;
+        problem.project(T, V);
+        return (X - V).template lpNorm<Eigen::Infinity>();
+    }
+
+    /**
+     * @brief Next Y from type-II Anderson acceleration
+     *
+     * The iteration maps Y (now Y_prev) to X = G(Y), with residual
+     * F = X - Y. With the differences dF, dG of the last m residuals and
+     * map values, Y = X - dG * gamma where gamma minimizes ||F - dF * gamma||.
+     * When the residual grows the history is dropped and the difference
+     * spanning the reset is not stored, so that iteration takes the plain
+     * step Y = X and the new history starts from the next one.
+     */
+    void anderson_step() {
+        T = X - Y_prev;   // residual F
+        double res = T.squaredNorm();
+        bool reset = res > res_prev;
+        if (reset) n_hist = 0;
+        res_prev = res;
+
+        if (iter > 1 && !reset) {  // F_prev, G_prev are from the previous iteration
+            int col = n_hist % m;
+            dF.col(col) = T - F_prev;
+            dG.col(col) = X - G_prev;
+            n_hist++;
+        }
+        F_prev = T;
+        G_prev = X;
+
+        Y = X;
+        int h = std::min(n_hist, m);
+        if (h == 0) return;
+
+        Small_mat M = dF.leftCols(h).transpose() * dF.leftCols(h);
+        M.diagonal().array() += 1e-10 * (1 + M.diagonal().maxCoeff());
+        Small_vec gamma = M.ldlt().solve(dF.leftCols(h).transpose() * T);
+        Y.noalias() -= dG.leftCols(h) * gamma;
+    }
+
+    /**
+     * @brief Barzilai-Borwein step size against the previous Y iterate
+     *
+     * When P equals the previous iterate (e.g. right after a restart) the
+     * quotient is 0/0 and the last valid step is reused.
+     */
+    double bb_step(const Vec& P, const Vec& grad_P) {
+        double num = 0, den = 0;
+        for (Eigen::Index i = 0; i < P.size(); i++) {
+            double s = P(i) - Y_prev(i), r = grad_P(i) - grad_Y_prev(i);
+            num += s * r;
+            den += r * r;
+        }
+        if (den > 0) alpha_last = std::abs(num / den);
+        return alpha_last;
+    }
+
+    /**
+     * @brief Backtracking projected step from P
+     * @return true if the sufficient decrease test holds at the result
+     */
+    bool line_search(const Vec& P, const Vec& grad_P, double alpha, double ck,
+                     Vec& out, double& F_out) {
+        double grad_norm = grad_P.norm();
+        for (int back_iter = 1; ; back_iter++) {
+            T.noalias() = P - alpha * grad_P;
+            problem.project(T, out);
+            alpha *= opts.rho;
+            F_out = problem.objective(out); n_obj++;
+
+            bool decrease = (ck - F_out) >= opts.del * (P - out).squaredNorm();
+            if (decrease || grad_norm < 1e-15 || back_iter > opts.max_back_iter)
+                return decrease;
+        }
+    }
+
+    Problem& problem;
+    PGD_options opts;
+
+    Vec X, Y, Z, V, T, X_prev, Y_prev;
+    Vec grad_X, grad_Y, grad_Y_prev;
+    double FX = 0, FZ = 0, FV = 0;
+    double alpha_last = 1;
+    int iter = 0, n_obj = 0, n_grad = 0;
+
+    // Anderson history, columns used as a ring of the last m differences
+    using Hist = Eigen::Matrix<double, N, Eigen::Dynamic, Eigen::ColMajor, N, PGD_max_anderson_memory>;
+    using Small_mat = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor,
+                                    PGD_max_anderson_memory, PGD_max_anderson_memory>;
+    using Small_vec = Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, PGD_max_anderson_memory, 1>;
+    Hist dF, dG;
+    Vec F_prev, G_prev;
+    int m = 0, n_hist = 0;
+    double res_prev = 0;
+};
+
+#endif
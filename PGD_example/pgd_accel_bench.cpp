@@ -0,0 +1,92 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "pgd.hpp"
+#include "pgd_problems.hpp"
+
+// Iterations and wall time of each acceleration strategy over a random
+// start set; every strategy stops on the same tolerance (PGD_options::tol).
+
+struct Strategy {
+    const char* name;
+    PGD_acceleration acceleration;
+    int anderson_memory;
+};
+
+const std::vector<Strategy> strategies = {
+    {"nesterov", PGD_acceleration::nesterov, 0},
+    {"restart_f", PGD_acceleration::restart_function, 0},
+    {"restart_g", PGD_acceleration::restart_gradient, 0},
+    {"anderson2", PGD_acceleration::anderson, 2},
+    {"anderson5", PGD_acceleration::anderson, 5},
+};
+
+template <int N, class Problem>
+void bench(const char* label, Problem& problem, int n, const std::vector<typename Problem::Vec>& starts, int n_rep) {
+    std::cout << label << std::endl;
+    std::cout << std::setw(12) << "strategy" << std::setw(10) << "iter" << std::setw(10) << "max_it"
+              << std::setw(10) << "f_eval" << std::setw(14) << "time/solve" << std::setw(14) << "mean f"
+              << std::setw(10) << "hit max" << std::endl;
+
+    for (const Strategy& s : strategies) {
+        PGD_options opts;
+        opts.max_iter = 1000;
+        opts.acceleration = s.acceleration;
+        opts.anderson_memory = s.anderson_memory;
+        PGD<N, Problem> solver(problem, n, opts);
+
+        long iter_sum = 0, f_eval_sum = 0;
+        int iter_max = 0, hit_max = 0;
+        double f_sum = 0;
+        for (const auto& X0 : starts) {
+            solver.solve(X0);
+            iter_sum += solver.iterations();
+            f_eval_sum += solver.obj_evals();
+            iter_max = std::max(iter_max, solver.iterations());
+            hit_max += solver.iterations() >= opts.max_iter;
+            f_sum += solver.objective();
+        }
+
+        auto tic = std::chrono::high_resolution_clock::now();
+        for (int rep = 0; rep < n_rep; rep++)
+            for (const auto& X0 : starts) solver.solve(X0);
+        auto toc = std::chrono::high_resolution_clock::now();
+        double t = std::chrono::duration<double>(toc - tic).count() / (n_rep * starts.size());
+
+        std::cout << std::setw(12) << s.name
+                  << std::setw(10) << double(iter_sum) / starts.size() << std::setw(10) << iter_max
+                  << std::setw(10) << double(f_eval_sum) / starts.size()
+                  << std::setw(14) << t << std::setw(14) << f_sum / starts.size()
+                  << std::setw(10) << hit_max << std::endl;
+    }
+}
+
+int main() {
+    const int n_starts = 200;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+
+    {
+        Quartic_problem problem;
+        std::vector<Eigen::Vector2d> starts(n_starts);
+        for (auto& X0 : starts) X0 = Eigen::Vector2d(dist(gen), dist(gen));
+        bench<2>("[quartic, n = 2]", problem, 2, starts, 100);
+    }
+    {
+        const int n = 16;
+        Separable_problem<n> problem(n);
+        std::vector<Separable_problem<n>::Vec> starts(n_starts);
+        for (auto& X0 : starts) X0 = Separable_problem<n>::Vec::NullaryExpr(n, [&]() { return dist(gen); });
+        bench<n>("[separable, n = 16]", problem, n, starts, 20);
+    }
+    {
+        const int n = 1000;
+        Separable_problem<Eigen::Dynamic> problem(n);
+        std::vector<Separable_problem<Eigen::Dynamic>::Vec> starts(n_starts / 10);
+        for (auto& X0 : starts) X0 = Separable_problem<Eigen::Dynamic>::Vec::NullaryExpr(n, [&]() { return dist(gen); });
+        bench<Eigen::Dynamic>("[separable, n = 1000]", problem, n, starts, 2);
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+#include <iostream>
+#include <chrono>
+#include "pgd.hpp"
+#include "pgd_problems.hpp"
+
+template <int N>
+void bench(int n, int n_rep, const char* storage) {
+    using Problem = Separable_problem<N>;
+    Problem problem(n);
+    PGD_options opts;
+    opts.max_iter = 1000;
+    PGD<N, Problem> solver(problem, n, opts);
+    typename Problem::Vec X0 = Problem::Vec::Constant(n, 1.0);
+
+    solver.solve(X0);  // warmup
+    auto tic = std::chrono::high_resolution_clock::now();
+    for (int rep = 0; rep < n_rep; rep++) solver.solve(X0);
+    auto toc = std::chrono::high_resolution_clock::now();
+    double t = std::chrono::duration<double>(toc - tic).count() / n_rep;
+
+    std::cout << "[PGD] n: " << n << " (" << storage << ")"
+              << ", iter: " << solver.iterations()
+              << ", objective: " << solver.objective()
+              << ", time/solve: " << t << "s"
+              << ", time/iter: " << t / solver.iterations() << "s" << std::endl;
+}
+
+int main() {
+    bench<2>(2, 100000, "fixed");
+    bench<Eigen::Dynamic>(2, 100000, "dynamic");
+    bench<16>(16, 20000, "fixed");
+    bench<Eigen::Dynamic>(16, 20000, "dynamic");
+    bench<Eigen::Dynamic>(1000, 200, "dynamic");
+    bench<Eigen::Dynamic>(1000000, 1, "dynamic");
+    return 0;
+}
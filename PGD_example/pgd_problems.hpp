@@ -0,0 +1,67 @@
+#ifndef PGD_PROBLEMS_HPP
+#define PGD_PROBLEMS_HPP
+
+#include <cmath>
+#include <Eigen/Dense>
+#include "projections.hpp"
+
+/**
+ * @brief 2-D problem of 1_cmp_pgd_ex.cpp on the ball ||x - C|| <= radius
+ *
+ * f(x) = 15*(x1^2-1)^2 + (x2^2-2)^2 + 4*x1*x2 + x1 + x2
+ */
+struct Quartic_problem {
+    using Vec = Eigen::Vector2d;
+
+    Vec C = Vec(0, 1.2);
+    double radius = 0.5;
+
+    double objective(const Vec& X) const {
+        return 15.0*pow(X(0)*X(0)-1 , 2) + 1.0*pow(X(1)*X(1)-2 , 2) + 4*X(0)*X(1) + X(0) + X(1);
+    }
+
+    void gradient(const Vec& X, Vec& grad_X) const {
+        grad_X << 4*X(1) + 60*X(0)*(X(0)*X(0) - 1) + 1,
+                  4*X(0) + 4*X(1)*(X(1)*X(1) - 2) + 1;
+    }
+
+    void project(const Vec& X, Vec& Z) const {
+        Ball_projection<2>(C, radius)(X, Z);
+    }
+};
+
+/**
+ * @brief Separable n-D problem in the style of 2_test_largeProb
+ *
+ * f(x) = sum_i (x_i - a_i)^4 + sin(x_i) + exp(0.1 x_i), a_i = i / n,
+ * on the ball ||x|| <= radius. N is the compile-time size or Eigen::Dynamic.
+ */
+template <int N>
+struct Separable_problem {
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    Vec a;
+    double radius;
+
+    explicit Separable_problem(int n = N, double radius = 0.0)
+        : a(Vec::LinSpaced(n, 0.0, (n - 1.0) / n)),
+          radius(radius > 0 ? radius : 0.5 * std::sqrt(double(n))) {}
+
+    double objective(const Vec& X) const {
+        return ((X - a).array().square().square() + X.array().sin() + (0.1 * X.array()).exp()).sum();
+    }
+
+    void gradient(const Vec& X, Vec& grad_X) const {
+        grad_X = 4 * (X - a).array().cube() + X.array().cos() + 0.1 * (0.1 * X.array()).exp();
+    }
+
+    void project(const Vec& X, Vec& Z) const {
+        double norm = X.norm();
+        if (norm > radius)
+            Z = radius / norm * X;
+        else
+            Z = X;
+    }
+};
+
+#endif
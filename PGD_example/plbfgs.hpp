@@ -0,0 +1,175 @@
+#ifndef PLBFGS_HPP
+#define PLBFGS_HPP
+
+#include <cmath>
+#include <algorithm>
+#include <Eigen/Dense>
+
+/**
+ * @brief Parameters of the projected L-BFGS solver
+ */
+struct LBFGS_options {
+    int memory = 5;          // stored (s, y) pairs
+    double tol = 1e-6;       // exit when ||x - P(x - grad f(x))||_inf < tol
+    double c1 = 1e-4;        // Armijo constant
+    double rho = 0.5;        // backtracking factor
+    int max_iter = 1000;
+    int max_back_iter = 30;
+};
+
+/**
+ * @brief Projected limited-memory BFGS in N dimensions
+ *
+ * Each iteration takes the L-BFGS direction d = -H grad f(x) from the two-loop
+ * recursion and backtracks along the projection arc x(t) = P(x + t d) until
+ * the Armijo condition f(x(t)) <= f(x) + c1 grad f(x)'(x(t) - x) holds. When
+ * the projected direction is not a descent direction, the step falls back to
+ * the scaled projected gradient d = -gamma grad f(x). Pairs (s, y) that fail
+ * the curvature test s'y > 0 are skipped.
+ *
+ * The last m pairs are kept as the columns of two n x m matrices used as a
+ * ring, so the memory is O(mn) in two contiguous blocks, and every vector is
+ * allocated once in the constructor. The Problem interface is the one of
+ * PGD in pgd.hpp:
+ *   double objective(const Vec& x);
+ *   void gradient(const Vec& x, Vec& g);
+ *   void project(const Vec& x, Vec& z);
+ */
+template <int N, class Problem>
+class Projected_LBFGS {
+public:
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    /**
+     * @brief Constructor
+     * @param problem Objective, gradient and projection
+     * @param n Problem size, only used when N is Eigen::Dynamic
+     * @param opts Algorithm parameters
+     */
+    Projected_LBFGS(Problem& problem, int n = N, const LBFGS_options& opts = LBFGS_options())
+        : problem(problem), opts(opts), m(std::max(1, opts.memory)) {
+        for (Vec* v : {&X, &G, &D, &X_new, &G_new, &T})
+            v->resize(n);
+        S.resize(n, m);
+        Yd.resize(n, m);
+        rho_hist.resize(m);
+        alpha_hist.resize(m);
+    }
+
+    /**
+     * @brief Solve from X_init; the result is available through solution()
+     */
+    void solve(const Vec& X_init) {
+        problem.project(X_init, X);
+        FX = problem.objective(X);
+        problem.gradient(X, G);
+        n_obj = 1; n_grad = 1;
+        n_hist = 0; head = 0;
+        iter = 0;
+        double gamma = 1.0 / std::max(1.0, G.template lpNorm<Eigen::Infinity>());
+
+        while ((res = residual()) >= opts.tol && iter < opts.max_iter) {
+            iter++;
+
+            direction(gamma);
+            if (!line_search()) {
+                if (n_hist == 0) break;  // no progress even along the projected gradient
+                n_hist = 0;
+                direction(gamma);
+                if (!line_search()) break;
+            }
+
+            problem.gradient(X_new, G_new); n_grad++;
+
+            // s = X_new - X and y = G_new - G, built in T and D, replace the oldest pair
+            T.noalias() = X_new - X;
+            D.noalias() = G_new - G;
+            double sy = T.dot(D), yy = D.squaredNorm();
+            if (sy > 1e-12 * yy && yy > 0) {
+                S.col(head) = T;
+                Yd.col(head) = D;
+                rho_hist(head) = 1 / sy;
+                gamma = sy / yy;
+                head = (head + 1) % m;
+                n_hist = std::min(n_hist + 1, m);
+            }
+
+            X.swap(X_new);
+            G.swap(G_new);
+            FX = F_new;
+        }
+    }
+
+    const Vec& solution() const { return X; }
+    double objective() const { return FX; }
+    double residual_norm() const { return res; }
+    int iterations() const { return iter; }
+    int obj_evals() const { return n_obj; }
+    int grad_evals() const { return n_grad; }
+
+private:
+    /**
+     * @brief Projected-gradient residual ||X - P(X - G)||_inf, zero at a stationary point
+     */
+    double residual() {
+        T.noalias() = X - G;
+        problem.project(T, X_new);
+        return (X - X_new).template lpNorm<Eigen::Infinity>();
+    }
+
+    /**
+     * @brief D = -H G by the two-loop recursion, with H0 = gamma I
+     */
+    void direction(double gamma) {
+        D = G;
+        for (int k = 0; k < n_hist; k++) {
+            int col = (head - 1 - k + m) % m;
+            alpha_hist(col) = rho_hist(col) * S.col(col).dot(D);
+            D.noalias() -= alpha_hist(col) * Yd.col(col);
+        }
+        D *= -gamma;
+        for (int k = n_hist - 1; k >= 0; k--) {
+            int col = (head - 1 - k + m) % m;
+            double beta = rho_hist(col) * Yd.col(col).dot(D);
+            D.noalias() -= (alpha_hist(col) + beta) * S.col(col);
+        }
+    }
+
+    /**
+     * @brief Backtracking along P(X + t D), falling back to D = -gamma G
+     * when the full projected step does not descend
+     * @return true if the Armijo condition holds at X_new
+     */
+    bool line_search() {
+        double t = 1;
+        for (int back_iter = 1; ; back_iter++) {
+            T.noalias() = X + t * D;
+            problem.project(T, X_new);
+            double descent = G.dot(X_new - X);
+            if (back_iter == 1 && descent >= 0 && n_hist > 0)
+                return false;  // caller drops the memory and retries
+            F_new = problem.objective(X_new); n_obj++;
+
+            if (F_new <= FX + opts.c1 * descent && descent < 0)
+                return true;
+            if (back_iter > opts.max_back_iter)
+                return false;
+            t *= opts.rho;
+        }
+    }
+
+    Problem& problem;
+    LBFGS_options opts;
+    int m;
+
+    Vec X, G, D, X_new, G_new, T;
+    double FX = 0, F_new = 0, res = 0;
+    int iter = 0, n_obj = 0, n_grad = 0;
+
+    // (s, y) pairs, column head is the next to be written
+    Eigen::Matrix<double, N, Eigen::Dynamic> S, Yd;
+    Eigen::VectorXd rho_hist, alpha_hist;
+    int n_hist = 0, head = 0;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdlib>
+#include "pgd.hpp"
+#include "plbfgs.hpp"
+#include "pgd_problems.hpp"
+
+// Nonmonotone APG (pgd.hpp) against projected L-BFGS (plbfgs.hpp) on the
+// separable problem for growing n. Both stop on the same rule, the
+// projected-gradient residual ||x - P(x - grad f(x))||_inf < res_tol (the
+// ck test of the APG is switched off), so the counts and times are at equal
+// accuracy. The residual each actually reached is printed next to them;
+// the APG pays one more gradient per iteration to test it.
+//
+// Usage: plbfgs_bench [res_tol]
+
+using Problem = Separable_problem<Eigen::Dynamic>;
+using Vec = Problem::Vec;
+
+double residual(Problem& problem, const Vec& X) {
+    Vec G(X.size()), Z(X.size());
+    problem.gradient(X, G);
+    problem.project(X - G, Z);
+    return (X - Z).lpNorm<Eigen::Infinity>();
+}
+
+template <class Solver>
+void run(const char* name, Problem& problem, Solver& solver, const std::vector<Vec>& starts) {
+    long iter_sum = 0, f_eval_sum = 0, g_eval_sum = 0;
+    double f_sum = 0, res_max = 0;
+
+    auto tic = std::chrono::high_resolution_clock::now();
+    for (const auto& X0 : starts) {
+        solver.solve(X0);
+        iter_sum += solver.iterations();
+        f_eval_sum += solver.obj_evals();
+        g_eval_sum += solver.grad_evals();
+        f_sum += solver.objective();
+    }
+    auto toc = std::chrono::high_resolution_clock::now();
+    double t = std::chrono::duration<double>(toc - tic).count() / starts.size();
+
+    for (const auto& X0 : starts) {
+        solver.solve(X0);
+        res_max = std::max(res_max, residual(problem, solver.solution()));
+    }
+
+    size_t k = starts.size();
+    std::cout << std::setw(8) << name
+              << std::setw(10) << double(iter_sum) / k << std::setw(10) << double(f_eval_sum) / k
+              << std::setw(10) << double(g_eval_sum) / k << std::setw(14) << t
+              << std::setw(16) << std::setprecision(10) << f_sum / k << std::setprecision(6)
+              << std::setw(14) << res_max << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    double res_tol = argc > 1 ? std::atof(argv[1]) : 1e-7;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+
+    // Default ball (inactive at the solution) and a small ball that is active
+    for (double radius_scale : {0.5, 0.05})
+    for (int n : {1000, 100000, 1000000}) {
+        Problem problem(n, radius_scale * std::sqrt(double(n)));
+        std::vector<Vec> starts(n >= 1000000 ? 1 : 5);
+        for (auto& X0 : starts) X0 = Vec::NullaryExpr(n, [&]() { return dist(gen); });
+
+        std::cout << "[separable, n = " << n << ", radius = " << radius_scale << " sqrt(n)]" << std::endl;
+        std::cout << std::setw(8) << "solver" << std::setw(10) << "iter" << std::setw(10) << "f_eval"
+                  << std::setw(10) << "g_eval" << std::setw(14) << "time/solve" << std::setw(16) << "mean f"
+                  << std::setw(14) << "max resid" << std::endl;
+
+        PGD_options pgd_opts;
+        pgd_opts.max_iter = 10000;
+        pgd_opts.tol = 0;
+        pgd_opts.res_tol = res_tol;
+        PGD<Eigen::Dynamic, Problem> apg(problem, n, pgd_opts);
+        run("apg", problem, apg, starts);
+
+        LBFGS_options lbfgs_opts;
+        lbfgs_opts.max_iter = 10000;
+        lbfgs_opts.tol = res_tol;
+        Projected_LBFGS<Eigen::Dynamic, Problem> lbfgs(problem, n, lbfgs_opts);
+        run("lbfgs", problem, lbfgs, starts);
+    }
+    return 0;
+}
@@ -0,0 +1,261 @@
+#ifndef PROJECTIONS_HPP
+#define PROJECTIONS_HPP
+
+#include <cmath>
+#include <vector>
+#include <Eigen/Dense>
+
+// Closed-form Euclidean projections for PGD<N, Problem>.
+//
+// Every operator is called as proj(x, z) and writes the projection of x
+// into z (x and z may not alias). Parameters are fixed at construction;
+// operators that need scratch space allocate it on the first call and
+// reuse it, so steady-state projections do not allocate.
+
+/**
+ * @brief Box lb <= x <= ub
+ */
+template <int N>
+struct Box_projection {
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    Vec lb, ub;
+
+    Box_projection(const Vec& lb, const Vec& ub) : lb(lb), ub(ub) {}
+
+    void operator()(const Vec& x, Vec& z) const {
+        z = x.cwiseMax(lb).cwiseMin(ub);
+    }
+};
+
+/**
+ * @brief Euclidean ball ||x - C|| <= radius
+ */
+template <int N>
+struct Ball_projection {
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    Vec C;
+    double radius;
+
+    Ball_projection(const Vec& C, double radius) : C(C), radius(radius) {}
+
+    void operator()(const Vec& x, Vec& z) const {
+        double dist = (x - C).norm();
+        if (dist > radius)
+            z = C + radius / dist * (x - C);
+        else
+            z = x;
+    }
+};
+
+/**
+ * @brief Halfspace a^T x <= b
+ */
+template <int N>
+struct Halfspace_projection {
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    Vec a;
+    double b;
+
+    Halfspace_projection(const Vec& a, double b) : a(a), b(b) {}
+
+    void operator()(const Vec& x, Vec& z) const {
+        double viol = a.dot(x) - b;
+        if (viol > 0)
+            z = x - viol / a.squaredNorm() * a;
+        else
+            z = x;
+    }
+};
+
+/**
+ * @brief Second-order cone ||x(1:n-1)|| <= x(0)
+ */
+template <int N>
+struct SOC_projection {
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    void operator()(const Vec& x, Vec& z) const {
+        double t = x(0);
+        double norm_v = x.tail(x.size() - 1).norm();
+        if (norm_v <= t) {
+            z = x;
+        } else if (norm_v <= -t) {
+            z.setZero(x.size());
+        } else {
+            double coef = (t + norm_v) / 2;
+            z.resize(x.size());
+            z(0) = coef;
+            z.tail(x.size() - 1) = coef / norm_v * x.tail(x.size() - 1);
+        }
+    }
+};
+
+/**
+ * @brief Simplex x >= 0, sum(x) = radius
+ *
+ * Sort-free algorithm of Condat, "Fast projection onto the simplex and the
+ * l1 ball" (2016): finds the threshold tau in expected O(n) with one pass
+ * plus a few cleanup passes over a shrinking candidate set.
+ */
+template <int N>
+struct Simplex_projection {
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    double radius;
+
+    explicit Simplex_projection(double radius = 1.0) : radius(radius) {}
+
+    void operator()(const Vec& x, Vec& z) const {
+        double tau = threshold(x.data(), x.size());
+        z = (x.array() - tau).cwiseMax(0.0);
+    }
+
+    /**
+     * @brief Threshold tau such that sum(max(y - tau, 0)) = radius
+     */
+    double threshold(const double* y, Eigen::Index n) const {
+        cand.clear();
+        rest.clear();
+
+        cand.push_back(y[0]);
+        double rho = y[0] - radius;
+        for (Eigen::Index i = 1; i < n; i++) {
+            if (y[i] <= rho) continue;
+            rho += (y[i] - rho) / (cand.size() + 1);
+            if (rho > y[i] - radius) {
+                cand.push_back(y[i]);
+            } else {
+                rest.insert(rest.end(), cand.begin(), cand.end());
+                cand.assign(1, y[i]);
+                rho = y[i] - radius;
+            }
+        }
+        for (double v : rest) {
+            if (v <= rho) continue;
+            cand.push_back(v);
+            rho += (v - rho) / cand.size();
+        }
+
+        // Drop candidates below the running threshold until none remain
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            size_t kept = 0;
+            for (size_t i = 0; i < cand.size(); i++) {
+                double v = cand[i];
+                size_t remaining = kept + cand.size() - i - 1;
+                if (v > rho || remaining == 0) {
+                    cand[kept++] = v;
+                } else {
+                    rho += (rho - v) / remaining;
+                    changed = true;
+                }
+            }
+            cand.resize(kept);
+        }
+        return rho;
+    }
+
+private:
+    mutable std::vector<double> cand, rest;
+};
+
+/**
+ * @brief l1 ball ||x||_1 <= radius, through the simplex projection of |x|
+ */
+template <int N>
+struct L1_ball_projection {
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    explicit L1_ball_projection(double radius = 1.0) : simplex(radius) {}
+
+    void operator()(const Vec& x, Vec& z) const {
+        if (x.template lpNorm<1>() <= simplex.radius) {
+            z = x;
+            return;
+        }
+        abs_x = x.cwiseAbs();
+        double tau = simplex.threshold(abs_x.data(), abs_x.size());
+        z = x.cwiseSign().cwiseProduct((abs_x.array() - tau).cwiseMax(0.0).matrix());
+    }
+
+private:
+    Simplex_projection<N> simplex;
+    mutable Vec abs_x;
+};
+
+/**
+ * @brief Intersection of two convex sets by Dykstra's alternating projections
+ *
+ * Converges to the exact projection onto the intersection. z can stay put
+ * for many passes while the corrections p and q still move, so a pass only
+ * ends the loop when p and q changed by less than tol (squared, together)
+ * and the two partial projections y and z agree to tol; otherwise it stops
+ * after max_iter. Where the sets only touch (e.g. a box edge tangent to a
+ * ball) convergence is sublinear and can take thousands of passes, hence
+ * the large default max_iter. Nest Dykstra_projection for more than two sets.
+ */
+template <int N, class Proj1, class Proj2>
+struct Dykstra_projection {
+    using Vec = Eigen::Matrix<double, N, 1>;
+
+    Proj1 proj1;
+    Proj2 proj2;
+    int max_iter;
+    double tol;
+
+    Dykstra_projection(const Proj1& proj1, const Proj2& proj2, int max_iter = 20000, double tol = 1e-24)
+        : proj1(proj1), proj2(proj2), max_iter(max_iter), tol(tol) {}
+
+    void operator()(const Vec& x, Vec& z) const {
+        Eigen::Index n = x.size();
+        y.resize(n); p.resize(n); q.resize(n); t.resize(n);
+        p.setZero();
+        q.setZero();
+        z = x;
+
+        for (iter = 1; iter <= max_iter; iter++) {
+            t.noalias() = z + p;
+            proj1(t, y);
+            double change = (t - y - p).squaredNorm();
+            p = t - y;
+
+            t.noalias() = y + q;
+            proj2(t, z);
+            change += (t - z - q).squaredNorm();
+            q = t - z;
+
+            if (change < tol && (y - z).squaredNorm() < tol) break;
+        }
+    }
+
+    /**
+     * @brief Passes taken by the last call, max_iter + 1 if it hit the limit
+     */
+    int iterations() const { return iter; }
+
+private:
+    mutable Vec y, p, q, t;
+    mutable int iter = 0;
+};
+
+/**
+ * @brief Problem adaptor replacing the projection of Problem
+ */
+template <class Problem, class Projection>
+struct Constrained_problem : Problem {
+    Projection projection;
+
+    Constrained_problem(const Problem& problem, const Projection& projection)
+        : Problem(problem), projection(projection) {}
+
+    template <class Vec>
+    void project(const Vec& x, Vec& z) const {
+        projection(x, z);
+    }
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include "projections.hpp"
+
+// Checks of projections.hpp against projections known in closed form, and
+// of the sort-free simplex and l1 projections against a sort-based
+// reference. Returns nonzero if any check fails.
+
+using Vec2 = Eigen::Vector2d;
+using VecX = Eigen::VectorXd;
+
+int failures = 0;
+
+void check(const std::string& name, const VecX& z, const VecX& expected, double tol) {
+    double err = z.size() == expected.size() ? (z - expected).norm() : INFINITY;
+    bool ok = err <= tol;
+    failures += !ok;
+    std::cout << (ok ? "[ok]   " : "[FAIL] ") << name << ": error " << err << std::endl;
+}
+
+// Simplex threshold by sorting: tau = (sum of the k largest - radius) / k
+// for the largest k whose k-th largest entry is still above tau
+double simplex_threshold_sorted(VecX y, double radius) {
+    std::sort(y.data(), y.data() + y.size(), std::greater<double>());
+    double sum = 0, tau = 0;
+    for (Eigen::Index k = 0; k < y.size(); k++) {
+        sum += y(k);
+        double t = (sum - radius) / (k + 1);
+        if (y(k) > t) tau = t;
+    }
+    return tau;
+}
+
+VecX simplex_reference(const VecX& x, double radius) {
+    return (x.array() - simplex_threshold_sorted(x, radius)).cwiseMax(0.0);
+}
+
+VecX l1_ball_reference(const VecX& x, double radius) {
+    if (x.lpNorm<1>() <= radius) return x;
+    VecX abs_x = x.cwiseAbs();
+    double tau = simplex_threshold_sorted(abs_x, radius);
+    return x.cwiseSign().cwiseProduct((abs_x.array() - tau).cwiseMax(0.0).matrix());
+}
+
+// Simplex and l1 projections of x against the reference, in fixed and
+// dynamic size
+void check_simplex_l1(const std::string& name, const VecX& x, double radius) {
+    double tol = 1e-12 * (1 + x.cwiseAbs().maxCoeff());
+    Simplex_projection<Eigen::Dynamic> simplex(radius);
+    L1_ball_projection<Eigen::Dynamic> l1(radius);
+    VecX z;
+    simplex(x, z);
+    check("simplex, " + name, z, simplex_reference(x, radius), tol);
+    l1(x, z);
+    check("l1 ball, " + name, z, l1_ball_reference(x, radius), tol);
+}
+
+int main() {
+    using Box = Box_projection<2>;
+    using Ball = Ball_projection<2>;
+
+    {
+        // The ball lies inside the box and touches its lower edge, so the
+        // projection onto the intersection is the ball projection; z stalls
+        // for several passes here while p and q still move
+        Box box(Vec2(-0.5, 0.7), Vec2(0.5, 1.7));
+        Ball ball(Vec2(0.0, 1.2), 0.5);
+        Dykstra_projection<2, Box, Ball> proj(box, ball);
+        Vec2 x(0.665, -6.587), z, expected;
+        ball(x, expected);
+        proj(x, z);
+        check("Dykstra box/ball, tangent", z, expected, 1e-8);
+    }
+    {
+        // Unit ball cut by x0 <= 0.5: the projection of (2, 2) is the corner
+        // where the edge meets the circle
+        Box box(Vec2(-1.0, -1.0), Vec2(0.5, 1.0));
+        Ball ball(Vec2(0.0, 0.0), 1.0);
+        Dykstra_projection<2, Box, Ball> proj(box, ball);
+        Vec2 z;
+        proj(Vec2(2.0, 2.0), z);
+        check("Dykstra box/ball, corner", z, Vec2(0.5, std::sqrt(0.75)), 1e-8);
+    }
+
+    {
+        // Outside both the cone and its polar: (1, 3, 0) -> (2, 2, 0), into a
+        // default-constructed dynamic vector
+        SOC_projection<Eigen::Dynamic> proj;
+        Eigen::VectorXd x(3), z;
+        x << 1.0, 3.0, 0.0;
+        proj(x, z);
+        check("SOC, dynamic output", z.head<2>(), Vec2(2.0, 2.0), 1e-12);
+    }
+
+    {
+        Box_projection<3> box(Eigen::Vector3d(-1, -1, -1), Eigen::Vector3d(1, 1, 1));
+        Eigen::Vector3d z;
+        box(Eigen::Vector3d(-3.0, 0.2, 5.0), z);
+        check("box, outside", z, Eigen::Vector3d(-1.0, 0.2, 1.0), 0);
+        box(Eigen::Vector3d(0.3, -1.0, 1.0), z);
+        check("box, inside and on the boundary", z, Eigen::Vector3d(0.3, -1.0, 1.0), 0);
+    }
+    {
+        // a = (1, 1), b = 1: (2, 2) violates by 3 and moves by 3/2 along a
+        Halfspace_projection<2> half(Vec2(1.0, 1.0), 1.0);
+        Vec2 z;
+        half(Vec2(2.0, 2.0), z);
+        check("halfspace, outside", z, Vec2(0.5, 0.5), 1e-15);
+        half(Vec2(-3.0, 4.0), z);
+        check("halfspace, on the boundary", z, Vec2(-3.0, 4.0), 0);
+        half(Vec2(-3.0, 1.0), z);
+        check("halfspace, inside", z, Vec2(-3.0, 1.0), 0);
+    }
+    {
+        // C = (1, -1), radius 2: (4, 3) is at distance 5 along (3, 4) / 5
+        Ball ball(Vec2(1.0, -1.0), 2.0);
+        Vec2 z;
+        ball(Vec2(4.0, 3.0), z);
+        check("ball, outside", z, Vec2(2.2, 0.6), 1e-15);
+        ball(Vec2(1.0, 1.0), z);
+        check("ball, on the boundary", z, Vec2(1.0, 1.0), 0);
+        ball(Vec2(0.5, -0.5), z);
+        check("ball, inside", z, Vec2(0.5, -0.5), 0);
+    }
+
+    {
+        VecX x(4);
+        x << 0.1, 0.2, 0.3, 0.4;
+        check_simplex_l1("on the simplex", x, 1.0);
+        x << 0.1, -0.2, 0.05, 0.3;
+        check_simplex_l1("inside the l1 ball", x, 1.0);
+        x << 0.5, 0.5, 0.5, 0.5;
+        check_simplex_l1("all tied", x, 1.0);
+        x << 2.0, 2.0, -2.0, 0.0;
+        check_simplex_l1("tied magnitudes", x, 1.0);
+        x << 3.0, 1.0, 1.0, 1.0;
+        check_simplex_l1("ties below the threshold", x, 1.0);
+        x << -1.0, -2.0, -3.0, -4.0;
+        check_simplex_l1("all negative", x, 2.0);
+        x << 1e6, 1e6 + 1, -1e6, 0.5;
+        check_simplex_l1("large entries", x, 1.0);
+
+        VecX one(1);
+        one << -5.0;
+        check_simplex_l1("n = 1", one, 1.0);
+
+        // Random vectors, also rounded to a few levels so many entries tie
+        std::mt19937 gen(7);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        for (int n : {2, 5, 37, 1000}) {
+            for (double radius : {0.1, 1.0, 10.0}) {
+                VecX r(n), tied(n);
+                for (int i = 0; i < n; i++) {
+                    r(i) = normal(gen);
+                    tied(i) = std::round(2 * r(i)) / 2;
+                }
+                std::string tag = "n = " + std::to_string(n) + ", radius " + std::to_string(radius);
+                check_simplex_l1("random, " + tag, r, radius);
+                check_simplex_l1("rounded, " + tag, tied, radius);
+            }
+        }
+
+        // Fixed size
+        Simplex_projection<4> simplex4(1.0);
+        Eigen::Vector4d x4(0.9, -0.3, 0.9, 0.2), z4;
+        simplex4(x4, z4);
+        check("simplex, fixed size", z4, simplex_reference(x4, 1.0), 1e-14);
+    }
+
+    return failures != 0;
+}
@@ -0,0 +1,30 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <casadi/casadi.hpp>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// Timing and warm-start helpers shared by the benchmark and MPC examples
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+inline double seconds_since(bench_clock::time_point tic) {
+  return std::chrono::duration<double>(bench_clock::now() - tic).count();
+}
+
+// Nearest-rank p-quantile of v, p in [0, 1]; p = 1 is the maximum
+inline double percentile(std::vector<double> v, double p) {
+  std::sort(v.begin(), v.end());
+  size_t i = std::min(v.size()-1, static_cast<size_t>(p * (v.size()-1) + 0.5));
+  return v[i];
+}
+
+// Drop the first column and repeat the last one
+inline casadi::DM shift_columns(const casadi::DM& M) {
+  casadi_int n = M.size2();
+  return horzcat(M(casadi::Slice(), casadi::Slice(1, n)), M(casadi::Slice(), n-1));
+}
+
+#endif
@@ -1,4 +1,29 @@
 #include "casadi_api_a_test.hpp"
+#include "pgd_api_batch.hpp"
+#include "../PGD_example/projections.hpp"
+#include <cstdlib>
+
+// Count heap allocations to check that the solver loop does not allocate.
+// The array forms forward to these by default, so the scalar and aligned
+// overloads, with their matching deletes, cover every new expression.
+static size_t n_alloc = 0;
+
+void* operator new(std::size_t n) {
+    n_alloc++;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t n, std::align_val_t al) {
+    n_alloc++;
+    // aligned_alloc wants a nonzero multiple of the alignment
+    std::size_t a = static_cast<std::size_t>(al);
+    if (void* p = std::aligned_alloc(a, (std::max(n, a) + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
 
 int main () {
     Eigen::Vector2d X_init(0.2, 1.0); 
@@ -9,4 +34,51 @@ int main () {
     auto toc4 = std::chrono::high_resolution_clock::now();
     casadi_pgd_s.duration = toc4 - tic4;
     casadi_pgd_s.display_info();  
-}
\ No newline at end of file
+
+    size_t n_alloc_before = n_alloc;
+    casadi_pgd_s.solve(X_init);
+    size_t n_alloc_solve = n_alloc - n_alloc_before;
+    std::cout << "[PGD_API_s] heap allocations in solve: " << n_alloc_solve << std::endl;
+    if (n_alloc_solve != 0) {
+        std::cerr << "[PGD_API_s] error: solve() allocated on the heap" << std::endl;
+        return 1;
+    }
+
+#ifdef PGD_TELEMETRY
+    casadi_pgd_s.telemetry().save_mat("../mfiles/mat/pgd_telemetry.mat");
+    std::cout << "[PGD_API_s] " << casadi_pgd_s.telemetry().size()
+              << " iterations written to pgd_telemetry.mat" << std::endl;
+#endif
+
+    // Multi-start: a grid of starting points over [-2, 2] x [-2, 2]
+    const int n_grid = 20;
+    std::vector<Eigen::Vector2d> starts;
+    for (int i = 0; i < n_grid; i++)
+        for (int j = 0; j < n_grid; j++)
+            starts.emplace_back(-2.0 + 4.0 * i / (n_grid - 1), -2.0 + 4.0 * j / (n_grid - 1));
+
+    // Serial loop vs batch over the same starts, best of n_rep runs each
+    const int n_rep = 20;
+    std::chrono::duration<double> serial(1e9), batch(1e9);
+    for (int rep = 0; rep < n_rep; rep++) {
+        auto tic5 = std::chrono::high_resolution_clock::now();
+        for (const auto& X0 : starts) casadi_pgd_s.solve(X0);
+        auto toc5 = std::chrono::high_resolution_clock::now();
+        serial = std::min<std::chrono::duration<double>>(serial, toc5 - tic5);
+    }
+    std::cout << "[PGD_API_s] " << starts.size() << " serial starts: " << serial.count() << "s" << std::endl;
+
+    // Box -0.5 <= x1 <= 0.5, 0.7 <= x2 <= 1.7 instead of the generated ball projection
+    PGD_API_s casadi_pgd_box(Box_projection<2>(Eigen::Vector2d(-0.5, 0.7), Eigen::Vector2d(0.5, 1.7)));
+    casadi_pgd_box.solve(X_init);
+    casadi_pgd_box.display_info();
+
+    PGD_API_batch casadi_pgd_batch;
+    for (int rep = 0; rep < n_rep; rep++) {
+        casadi_pgd_batch.solve(starts);
+        batch = std::min(batch, casadi_pgd_batch.duration);
+    }
+    casadi_pgd_batch.display_info();
+    std::cout << "[PGD_API_batch] " << starts.size() << " starts: " << batch.count() << "s, "
+              << serial.count() / batch.count() << "x the serial loop" << std::endl;
+}
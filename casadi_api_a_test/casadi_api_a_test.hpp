@@ -1,6 +1,16 @@
+#ifndef CASADI_API_A_TEST_HPP
+#define CASADI_API_A_TEST_HPP
+
 #include <iostream>
 #include <Eigen/Dense>
 #include <chrono>
+#include <new>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#ifdef PGD_TELEMETRY
+#include "pgd_telemetry.hpp"
+#endif
 // #include <casadi/casadi.hpp>
 
 using casadi_int = long long int;
@@ -14,24 +24,326 @@ extern "C" {
     int obj_fun_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
     int grad_fun_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
     int proj_fun_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+
+    int obj_fun_checkout(void);
+    int grad_fun_checkout(void);
+    int proj_fun_checkout(void);
+
+    void obj_fun_release(int mem);
+    void grad_fun_release(int mem);
+    void proj_fun_release(int mem);
+
+    void obj_fun_incref(void);
+    void grad_fun_incref(void);
+    void proj_fun_incref(void);
+
+    void obj_fun_decref(void);
+    void grad_fun_decref(void);
+    void proj_fun_decref(void);
+
+    // Fused kernels, only present in archives built by pgd_fun_gen
+    __attribute__((weak)) int obj_grad_fun(const double** arg, double** res, casadi_int* iw, double* w, int mem);
+    __attribute__((weak)) int proj_obj_fun(const double** arg, double** res, casadi_int* iw, double* w, int mem);
+
+    __attribute__((weak)) int obj_grad_fun_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+    __attribute__((weak)) int proj_obj_fun_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+
+    __attribute__((weak)) int obj_grad_fun_checkout(void);
+    __attribute__((weak)) int proj_obj_fun_checkout(void);
+
+    __attribute__((weak)) void obj_grad_fun_release(int mem);
+    __attribute__((weak)) void proj_obj_fun_release(int mem);
+
+    // Single-precision kernels (casadi_real = float) from pgd_fun_f.c, only
+    // present in archives built by pgd_fun_gen
+    __attribute__((weak)) int obj_fun_f(const float** arg, float** res, casadi_int* iw, float* w, int mem);
+    __attribute__((weak)) int grad_fun_f(const float** arg, float** res, casadi_int* iw, float* w, int mem);
+    __attribute__((weak)) int proj_fun_f(const float** arg, float** res, casadi_int* iw, float* w, int mem);
+    __attribute__((weak)) int obj_grad_fun_f(const float** arg, float** res, casadi_int* iw, float* w, int mem);
+    __attribute__((weak)) int proj_obj_fun_f(const float** arg, float** res, casadi_int* iw, float* w, int mem);
+
+    __attribute__((weak)) int obj_fun_f_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+    __attribute__((weak)) int grad_fun_f_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+    __attribute__((weak)) int proj_fun_f_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+    __attribute__((weak)) int obj_grad_fun_f_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+    __attribute__((weak)) int proj_obj_fun_f_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+
+    __attribute__((weak)) int obj_fun_f_checkout(void);
+    __attribute__((weak)) int grad_fun_f_checkout(void);
+    __attribute__((weak)) int proj_fun_f_checkout(void);
+    __attribute__((weak)) int obj_grad_fun_f_checkout(void);
+    __attribute__((weak)) int proj_obj_fun_f_checkout(void);
+
+    __attribute__((weak)) void obj_fun_f_release(int mem);
+    __attribute__((weak)) void grad_fun_f_release(int mem);
+    __attribute__((weak)) void proj_fun_f_release(int mem);
+    __attribute__((weak)) void obj_grad_fun_f_release(int mem);
+    __attribute__((weak)) void proj_obj_fun_f_release(int mem);
+
+    __attribute__((weak)) void obj_fun_f_incref(void);
+    __attribute__((weak)) void grad_fun_f_incref(void);
+    __attribute__((weak)) void proj_fun_f_incref(void);
+
+    __attribute__((weak)) void obj_fun_f_decref(void);
+    __attribute__((weak)) void grad_fun_f_decref(void);
+    __attribute__((weak)) void proj_fun_f_decref(void);
 }
 
+/**
+ * @brief Entry points of one generated kernel; null for a missing weak symbol
+ */
+template <class Real>
+struct PGD_kernel_entry {
+    int (*eval)(const Real**, Real**, casadi_int*, Real*, int);
+    int (*work)(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+    int (*checkout)(void);
+    void (*release)(int);
+    void (*incref)(void);
+    void (*decref)(void);
+};
+
+/**
+ * @brief The generated kernels of one precision, in the order
+ * obj, grad, proj, obj_grad, proj_obj
+ */
+template <class Real> struct PGD_kernel_set;
+
+template <> struct PGD_kernel_set<double> {
+    static constexpr PGD_kernel_entry<double> entries[5] = {
+        {obj_fun, obj_fun_work, obj_fun_checkout, obj_fun_release, obj_fun_incref, obj_fun_decref},
+        {grad_fun, grad_fun_work, grad_fun_checkout, grad_fun_release, grad_fun_incref, grad_fun_decref},
+        {proj_fun, proj_fun_work, proj_fun_checkout, proj_fun_release, proj_fun_incref, proj_fun_decref},
+        {obj_grad_fun, obj_grad_fun_work, obj_grad_fun_checkout, obj_grad_fun_release, nullptr, nullptr},
+        {proj_obj_fun, proj_obj_fun_work, proj_obj_fun_checkout, proj_obj_fun_release, nullptr, nullptr}};
+};
+
+template <> struct PGD_kernel_set<float> {
+    static constexpr PGD_kernel_entry<float> entries[5] = {
+        {obj_fun_f, obj_fun_f_work, obj_fun_f_checkout, obj_fun_f_release, obj_fun_f_incref, obj_fun_f_decref},
+        {grad_fun_f, grad_fun_f_work, grad_fun_f_checkout, grad_fun_f_release, grad_fun_f_incref, grad_fun_f_decref},
+        {proj_fun_f, proj_fun_f_work, proj_fun_f_checkout, proj_fun_f_release, proj_fun_f_incref, proj_fun_f_decref},
+        {obj_grad_fun_f, obj_grad_fun_f_work, obj_grad_fun_f_checkout, obj_grad_fun_f_release, nullptr, nullptr},
+        {proj_obj_fun_f, proj_obj_fun_f_work, proj_obj_fun_f_checkout, proj_obj_fun_f_release, nullptr, nullptr}};
+};
+
+/**
+ * @brief Shared evaluation context for the generated PGD kernels
+ *
+ * Checks out a memory slot of obj_fun, grad_fun and proj_fun and queries
+ * their work sizes once. A single 64-byte aligned arena holds the largest
+ * arg/res pointer arrays and iw/w work vectors, shared by all three kernels,
+ * so evaluations do no allocation and no work-size queries.
+ *
+ * When the linked archive also provides the fused obj_grad_fun and
+ * proj_obj_fun kernels, obj_grad() and proj_obj() use them so shared
+ * subexpressions and call overhead are paid once; otherwise they fall
+ * back to the separate kernels.
+ *
+ * Real selects the kernel precision: double uses the kernels above,
+ * float the *_fun_f kernels generated with casadi_real = float. The float
+ * kernels are optional; without them available() is false and no
+ * evaluation may be made.
+ */
+template <class Real>
+class PGD_kernels_t {
+public:
+    PGD_kernels_t() {
+        const auto& k = PGD_kernel_set<Real>::entries;
+        n_used = 0;
+        if (!(k[obj_k].eval && k[grad_k].eval && k[proj_k].eval))
+            return;
+        fused = k[obj_grad_k].eval && k[proj_obj_k].eval;
+        n_used = fused ? n_kernels : obj_grad_k;
+
+        for (int i = 0; i < n_used; i++)
+            if (k[i].incref) k[i].incref();
+        for (int i = 0; i < n_used; i++)
+            mem[i] = k[i].checkout();
+
+        casadi_int sz[n_kernels][4] = {};
+        for (int i = 0; i < n_used; i++)
+            k[i].work(&sz[i][0], &sz[i][1], &sz[i][2], &sz[i][3]);
+        for (int j = 0; j < 4; j++) {
+            sz_max[j] = 1;
+            for (int i = 0; i < n_kernels; i++) sz_max[j] = std::max(sz_max[j], sz[i][j]);
+        }
+
+        // Layout: [arg pointers | res pointers | iw | w], each block 64-byte aligned
+        size_t off_res = align(sz_max[0] * sizeof(const Real*));
+        size_t off_iw = off_res + align(sz_max[1] * sizeof(Real*));
+        size_t off_w = off_iw + align(sz_max[2] * sizeof(casadi_int));
+        arena_bytes = off_w + align(sz_max[3] * sizeof(Real));
+
+        arena = static_cast<char*>(::operator new(arena_bytes, std::align_val_t(alignment)));
+        arg = reinterpret_cast<const Real**>(arena);
+        res = reinterpret_cast<Real**>(arena + off_res);
+        iw = reinterpret_cast<casadi_int*>(arena + off_iw);
+        w = reinterpret_cast<Real*>(arena + off_w);
+    }
+
+    ~PGD_kernels_t() {
+        if (n_used == 0) return;
+        const auto& k = PGD_kernel_set<Real>::entries;
+        ::operator delete(arena, std::align_val_t(alignment));
+        for (int i = n_used - 1; i >= 0; i--)
+            k[i].release(mem[i]);
+        for (int i = n_used - 1; i >= 0; i--)
+            if (k[i].decref) k[i].decref();
+    }
+
+    PGD_kernels_t(const PGD_kernels_t&) = delete;
+    PGD_kernels_t& operator=(const PGD_kernels_t&) = delete;
+
+    /**
+     * @brief Evaluate the objective at x
+     */
+    void obj(const Real x[2], Real& result) {
+        arg[0] = x;
+        res[0] = &result;
+        call(obj_k);
+    }
+
+    /**
+     * @brief Evaluate the gradient at x
+     */
+    void grad(const Real x[2], Real grad_out[2]) {
+        arg[0] = x;
+        res[0] = grad_out;
+        call(grad_k);
+    }
+
+    /**
+     * @brief Project input onto the ball with center C and radius r
+     */
+    void proj(const Real input[2], const Real C[2], const Real& r, Real proj_out[2]) {
+        arg[0] = input;
+        arg[1] = C;
+        arg[2] = &r;
+        res[0] = proj_out;
+        call(proj_k);
+    }
+
+    /**
+     * @brief Evaluate objective and gradient at the same point
+     */
+    void obj_grad(const Real x[2], Real& result, Real grad_out[2]) {
+        if (!fused) {
+            obj(x, result);
+            grad(x, grad_out);
+            return;
+        }
+        arg[0] = x;
+        res[0] = &result;
+        res[1] = grad_out;
+        call(obj_grad_k);
+    }
+
+    /**
+     * @brief Project input onto the ball and evaluate the objective there
+     */
+    void proj_obj(const Real input[2], const Real C[2], const Real& r,
+                  Real proj_out[2], Real& result) {
+        if (!fused) {
+            proj(input, C, r, proj_out);
+            obj(proj_out, result);
+            return;
+        }
+        arg[0] = input;
+        arg[1] = C;
+        arg[2] = &r;
+        res[0] = proj_out;
+        res[1] = &result;
+        call(proj_obj_k);
+    }
+
+    bool available() const { return n_used > 0; }
+    bool has_fused() const { return fused; }
+    size_t workspace_bytes() const { return arena_bytes; }
+
+private:
+    enum { obj_k, grad_k, proj_k, obj_grad_k, proj_obj_k, n_kernels };
+
+    static constexpr size_t alignment = 64;
+    static size_t align(size_t n) { return (n + alignment - 1) / alignment * alignment; }
+
+    void call(int i) {
+        PGD_kernel_set<Real>::entries[i].eval(arg, res, iw, w, mem[i]);
+    }
+
+    int mem[n_kernels] = {};
+    int n_used;
+    bool fused = false;
+    casadi_int sz_max[4] = {};
+    size_t arena_bytes = 0;
+    char* arena = nullptr;
+
+    const Real** arg = nullptr;
+    Real** res = nullptr;
+    casadi_int* iw = nullptr;
+    Real* w = nullptr;
+};
+
+using PGD_kernels = PGD_kernels_t<double>;
+
+/**
+ * @brief Kernel precision of PGD_API_s
+ *
+ * double_only: every evaluation in double (the default)
+ * float_only:  every evaluation with the float kernels
+ * mixed:       float kernels until ck stalls at float resolution or meets
+ *              the tolerance, then a few iterations with the double kernels
+ */
+enum class PGD_precision { double_only, float_only, mixed };
+
 /**
  * @brief CasADi PGD API class using static libraries
  * 
  * This class implements the Projected Gradient Descent (PGD) algorithm
  * using CasADi-generated static libraries for objective function,
  * gradient function, and projection function evaluations.
- * If libpgd_fun.a doesn't exist, it will automatically generate and build it.
+ * The kernels come from the pgd_fun static library target, whose C sources
+ * are generated at build time by pgd_fun_gen (see CMakeLists.txt).
+ *
+ * Each instance owns a PGD_kernels context (its own kernel memory slots
+ * and workspace) and keeps all iteration state in members, so separate
+ * instances can solve concurrently from different threads.
+ *
+ * With set_precision() the kernels can run in float (see PGD_precision).
+ * The iterates, step sizes and ck stay in double, only the objective,
+ * gradient and projection evaluations change precision. Without float
+ * kernels in the archive every solve runs in double.
+ *
+ * Built with PGD_TELEMETRY defined, every iteration is recorded into a
+ * PGD_telemetry ring buffer (see telemetry()); without it the recording
+ * code is not compiled.
  */
 class PGD_API_s {
 public:
     /**
      * @brief Constructor initializes the PGD solver with default parameters
      */
-    PGD_API_s() {
-        C[0] = 0.0; C[1] = 1.2;
-        radius = 0.5;
+    PGD_API_s() : PGD_API_s(Eigen::Vector2d(0.0, 1.2), 0.5) {}
+
+    /**
+     * @brief Constructor for a given projection ball
+     * @param center Center of the feasible ball
+     * @param r Radius of the feasible ball
+     */
+    PGD_API_s(const Eigen::Vector2d& center, double r) {
+        set_problem(center, r);
+    }
+
+    /**
+     * @brief Projection callback replacing the generated proj_fun
+     */
+    using Projection = std::function<void(const Eigen::Vector2d& x, Eigen::Vector2d& z)>;
+
+    /**
+     * @brief Constructor with a native projection, e.g. from PGD_example/projections.hpp
+     * @param projection Called as projection(x, z) instead of proj_fun
+     */
+    explicit PGD_API_s(Projection projection) : PGD_API_s() {
+        this->projection = std::move(projection);
     }
 
     /**
@@ -39,6 +351,46 @@ public:
      */
     ~PGD_API_s() = default;
 
+    PGD_API_s(const PGD_API_s&) = delete;
+    PGD_API_s& operator=(const PGD_API_s&) = delete;
+
+    /**
+     * @brief Change the projection ball used by subsequent solves
+     * @param center Center of the feasible ball
+     * @param r Radius of the feasible ball
+     */
+    void set_problem(const Eigen::Vector2d& center, double r) {
+        C[0] = center(0); C[1] = center(1);
+        radius = r;
+        C_f[0] = float(C[0]); C_f[1] = float(C[1]);
+        radius_f = float(r);
+    }
+
+    /**
+     * @brief Stopping rule of subsequent solves
+     * @param tol Exit when (ck_plus - ck)^2 < tol
+     * @param iter_limit Maximum number of iterations
+     */
+    void set_tolerance(double tol, int iter_limit = 100) {
+        this->tol = tol;
+        max_iter_opt = iter_limit;
+    }
+
+    /**
+     * @brief Kernel precision of subsequent solves
+     * @param p double_only, float_only or mixed
+     * @param refine_iters Double iterations after the switch in mixed mode
+     */
+    void set_precision(PGD_precision p, int refine_iters = 5) {
+        precision = p;
+        this->refine_iters = refine_iters;
+    }
+
+    /**
+     * @brief Whether the linked archive provides the float kernels
+     */
+    bool has_float_kernels() const { return kernels_f.available(); }
+
     /**
      * @brief Solve PGD optimization problem with Eigen interface
      * @param X_init Initial guess as Eigen::Vector2d
@@ -57,6 +409,20 @@ public:
                   << ", X: (" << X[0] << ", " << X[1] << ")" << std::endl;
     }
 
+    Eigen::Vector2d solution() const { return Eigen::Vector2d(X[0], X[1]); }
+    double objective() const { return FX; }
+    int iterations() const { return iter; }
+    int obj_evals() const { return n_obj; }
+    int grad_evals() const { return n_grad; }
+    int float_iterations() const { return float_iter; }
+
+#ifdef PGD_TELEMETRY
+    /**
+     * @brief Iteration history of the last solve
+     */
+    const PGD_telemetry& telemetry() const { return telem; }
+#endif
+
     std::chrono::duration<double> duration;
 
 private:
@@ -71,9 +437,17 @@ private:
         for (int i = 0; i < 2; i++) {
             X[i] = X_init[i];
             Y[i] = X[i];
+            X_prev[i] = X[i];
         }
 
-        evaluate_obj(Y, FX);
+        n_obj = 0;
+        n_grad = 0;
+        use_float = precision != PGD_precision::double_only && kernels_f.available();
+        float_iter = 0;
+#ifdef PGD_TELEMETRY
+        telem.begin();
+#endif
+        evaluate_obj_grad(Y, FX, grad_Y);
         FX_prev = FX;
 
         for (int i = 0; i < 2; i++) {
@@ -84,26 +458,25 @@ private:
         tk = 1.0;
         qk = 1.0;
         ck = FX;
+        alpha_last = 1.0;
 
         eta = 0.4;
         del = 0.001;
-        max_iter = 100;
+        max_iter = max_iter_opt;
         iter = 0;
 
         // Main optimization loop
         while (true) {
             iter++;
 
-            evaluate_grad(Y, grad_Y);
+            if (iter > 1) evaluate_grad(Y, grad_Y);
 
             for (int i = 0; i < 2; i++) {
                 sk[i] = Y[i] - Y_prev[i];
                 rk[i] = grad_Y[i] - grad_Y_prev[i];
             }
 
-            double numerator = sk[0]*rk[0] + sk[1]*rk[1];
-            double denominator = rk[0]*rk[0] + rk[1]*rk[1];
-            alpha_Y = std::abs(numerator / denominator);
+            alpha_Y = bb_step();
 
             rho_Y = 0.5;
             back_iter = 0;
@@ -113,10 +486,8 @@ private:
                 back_iter++;
                 for (int i = 0; i < 2; i++)
                     temp[i] = Y[i] - alpha_Y * grad_Y[i];
-                evaluate_proj(temp, Z);
-
+                evaluate_proj_obj(temp, Z, FZ);
                 alpha_Y *= rho_Y;
-                evaluate_obj(Z, FZ);
 
                 double diff = (ck - FZ) - del * squared_distance(Y, Z);
                 if (diff >= 0 || back_iter > 10) break;
@@ -132,7 +503,7 @@ private:
                     sk[i] = X[i] - Y_prev[i];
                     rk[i] = grad_X[i] - grad_Y_prev[i];
                 }
-                alpha_X = std::abs( (sk[0]*rk[0] + sk[1]*rk[1]) / (rk[0]*rk[0] + rk[1]*rk[1]) );
+                alpha_X = bb_step();
 
                 rho_X = 0.5;
                 mon_iter = 0;
@@ -142,10 +513,8 @@ private:
                     mon_iter++;
                     for (int i = 0; i < 2; i++)
                         temp[i] = X[i] - alpha_X * grad_X[i];
-                    evaluate_proj(temp, V);
-
+                    evaluate_proj_obj(temp, V, FV);
                     alpha_X *= rho_X;
-                    evaluate_obj(V, FV);
 
                     double diff = (ck - FV) - del * squared_distance(Y, V);
                     if (diff >= 0 || mon_iter > 10) break;
@@ -160,11 +529,32 @@ private:
                 }
             }
 
+#ifdef PGD_TELEMETRY
+            // alpha_* were scaled by rho_* after the last trial, so undo it for the step taken
+            telem.record(iter, FX, ck, alpha_Y / rho_Y,
+                         accepted_Z ? std::numeric_limits<double>::quiet_NaN() : alpha_X / rho_X,
+                         back_iter, accepted_Z ? 0 : mon_iter, !accepted_Z && FV < FZ ? PGD_branch::V : PGD_branch::Z);
+#endif
+
             tk_plus = (1 + sqrt(1 + 4 * tk * tk)) / 2.0;
             qk_plus = eta * qk + 1;
             ck_plus = (eta * qk * ck + FX) / qk_plus;
 
-            if (pow(ck_plus - ck, 2) < 1e-6 || iter >= max_iter)
+            bool stop = pow(ck_plus - ck, 2) < tol || iter >= max_iter;
+            if (use_float) float_iter = iter;
+            if (use_float && precision == PGD_precision::mixed &&
+                (stop || std::abs(ck_plus - ck) <= float_stall * std::abs(ck))) {
+                // ck no longer moves in float: restart the reference from a
+                // double evaluation at X and finish with a few double
+                // iterations, never past the iteration limit
+                use_float = false;
+                evaluate_obj(X, FX);
+                qk_plus = 1;
+                ck_plus = FX;
+                max_iter = std::min(max_iter_opt, iter + refine_iters);
+                stop = iter >= max_iter;
+            }
+            if (stop)
                 break;
 
             for (int i = 0; i < 2; i++) {
@@ -189,13 +579,8 @@ private:
      * @param result Output objective value
      */
     void evaluate_obj(const double x[2], double& result) {
-        const double* arg[1] = {x};
-        double* res[1] = {&result};
-        casadi_int sz_arg, sz_res, sz_iw, sz_w;
-        obj_fun_work(&sz_arg, &sz_res, &sz_iw, &sz_w);
-        casadi_int iw[sz_iw];
-        double w[sz_w];
-        obj_fun(arg, res, iw, w, 0);
+        n_obj++;
+        kernel_obj(x, result);
     }
 
     /**
@@ -204,13 +589,14 @@ private:
      * @param grad_out Output gradient
      */
     void evaluate_grad(const double x[2], double grad_out[2]) {
-        const double* arg[1] = {x};
-        double* res[1] = {grad_out};
-        casadi_int sz_arg, sz_res, sz_iw, sz_w;
-        grad_fun_work(&sz_arg, &sz_res, &sz_iw, &sz_w);
-        casadi_int iw[sz_iw];
-        double w[sz_w];
-        grad_fun(arg, res, iw, w, 0);
+        n_grad++;
+        if (use_float) {
+            float x_f[2] = {float(x[0]), float(x[1])}, grad_f[2];
+            kernels_f.grad(x_f, grad_f);
+            grad_out[0] = grad_f[0]; grad_out[1] = grad_f[1];
+            return;
+        }
+        kernels.grad(x, grad_out);
     }
 
     /**
@@ -219,15 +605,89 @@ private:
      * @param proj_out Output projected point
      */
     void evaluate_proj(const double input[2], double proj_out[2]) {
-        const double* arg[3] = {input, C, &radius};
-        double* res[1] = {proj_out};
-        casadi_int sz_arg, sz_res, sz_iw, sz_w;
-        // proj_fun_work_ptr(&sz_arg, &sz_res, &sz_iw, &sz_w);
-        proj_fun_work(&sz_arg, &sz_res, &sz_iw, &sz_w);
-        casadi_int iw[sz_iw];
-        double w[sz_w];
-        // proj_fun_ptr(arg, res, iw, w, 0);
-        proj_fun(arg, res, iw, w, 0);
+        if (projection) {
+            Eigen::Vector2d z;
+            projection(Eigen::Vector2d(input[0], input[1]), z);
+            proj_out[0] = z(0); proj_out[1] = z(1);
+            return;
+        }
+        if (use_float) {
+            float in_f[2] = {float(input[0]), float(input[1])}, out_f[2];
+            kernels_f.proj(in_f, C_f, radius_f, out_f);
+            proj_out[0] = out_f[0]; proj_out[1] = out_f[1];
+            return;
+        }
+        kernels.proj(input, C, radius, proj_out);
+    }
+
+    /**
+     * @brief Evaluate objective and gradient at the same point
+     * @param x Input point
+     * @param result Output objective value
+     * @param grad_out Output gradient
+     */
+    void evaluate_obj_grad(const double x[2], double& result, double grad_out[2]) {
+        n_obj++;
+        n_grad++;
+        if (use_float) {
+            float x_f[2] = {float(x[0]), float(x[1])}, f_f, grad_f[2];
+            kernels_f.obj_grad(x_f, f_f, grad_f);
+            result = f_f;
+            grad_out[0] = grad_f[0]; grad_out[1] = grad_f[1];
+            return;
+        }
+        kernels.obj_grad(x, result, grad_out);
+    }
+
+    /**
+     * @brief Project a point and evaluate the objective at the projection
+     * @param input Input point
+     * @param proj_out Output projected point
+     * @param result Output objective value at proj_out
+     */
+    void evaluate_proj_obj(const double input[2], double proj_out[2], double& result) {
+        n_obj++;
+        if (projection) {
+            evaluate_proj(input, proj_out);
+            kernel_obj(proj_out, result);
+            return;
+        }
+        if (use_float) {
+            float in_f[2] = {float(input[0]), float(input[1])}, out_f[2], f_f;
+            kernels_f.proj_obj(in_f, C_f, radius_f, out_f, f_f);
+            proj_out[0] = out_f[0]; proj_out[1] = out_f[1];
+            result = f_f;
+            return;
+        }
+        kernels.proj_obj(input, C, radius, proj_out, result);
+    }
+
+    /**
+     * @brief Objective kernel of the current precision, not counted
+     * @param x Input point
+     * @param result Output objective value
+     */
+    void kernel_obj(const double x[2], double& result) {
+        if (use_float) {
+            float x_f[2] = {float(x[0]), float(x[1])}, f_f;
+            kernels_f.obj(x_f, f_f);
+            result = f_f;
+            return;
+        }
+        kernels.obj(x, result);
+    }
+
+    /**
+     * @brief Barzilai-Borwein step size from sk and rk
+     *
+     * When the gradient difference rk is zero (float evaluations near the
+     * solution) the quotient is 0/0 and the last valid step is reused.
+     */
+    double bb_step() {
+        double denominator = rk[0]*rk[0] + rk[1]*rk[1];
+        if (denominator > 0)
+            alpha_last = std::abs((sk[0]*rk[0] + sk[1]*rk[1]) / denominator);
+        return alpha_last;
     }
 
     /**
@@ -242,6 +702,20 @@ private:
 
     // Problem parameters
     double C[2], radius;
+    Projection projection;
+
+    // Generated kernels with their memory slots and workspace
+    PGD_kernels kernels;
+    PGD_kernels_t<float> kernels_f;
+    float C_f[2], radius_f;
+
+    // Kernel precision; use_float is the precision of the running solve
+    PGD_precision precision = PGD_precision::double_only;
+    int refine_iters = 5;
+    bool use_float = false;
+    int float_iter = 0;
+    // Relative change of ck below which float evaluations have stalled
+    static constexpr double float_stall = 4 * std::numeric_limits<float>::epsilon();
     
     // Optimization variables
     double X[2], Y[2], X_prev[2], Y_prev[2];
@@ -250,8 +724,17 @@ private:
     double FX, FX_prev, FZ, FV;
     double tk, tk_plus, qk, qk_plus, ck, ck_plus;
     double eta, del;
-    double alpha_Y, alpha_X;
-    int rho_Y, rho_X;
+    double alpha_Y, alpha_X, alpha_last;
+    double rho_Y, rho_X;
     int iter, max_iter;
+    double tol = 1e-6;
+    int max_iter_opt = 100;
+    int n_obj, n_grad;
     int back_iter, mon_iter;
-}; 
\ No newline at end of file
+
+#ifdef PGD_TELEMETRY
+    PGD_telemetry telem;
+#endif
+};
+
+#endif
@@ -0,0 +1,472 @@
+#ifndef PGD_API_BATCH_HPP
+#define PGD_API_BATCH_HPP
+
+#include "casadi_api_a_test.hpp"
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+// Batched kernels, only present in archives built by pgd_fun_gen. Each
+// evaluates PGD_batch_lanes points per call; inputs and outputs are one
+// coordinate over the lanes (structure-of-arrays).
+extern "C" {
+    __attribute__((weak)) int obj_fun_batch(const double** arg, double** res, casadi_int* iw, double* w, int mem);
+    __attribute__((weak)) int grad_fun_batch(const double** arg, double** res, casadi_int* iw, double* w, int mem);
+    __attribute__((weak)) int proj_obj_fun_batch(const double** arg, double** res, casadi_int* iw, double* w, int mem);
+
+    __attribute__((weak)) int obj_fun_batch_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+    __attribute__((weak)) int grad_fun_batch_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+    __attribute__((weak)) int proj_obj_fun_batch_work(casadi_int*, casadi_int*, casadi_int*, casadi_int*);
+
+    __attribute__((weak)) int obj_fun_batch_checkout(void);
+    __attribute__((weak)) int grad_fun_batch_checkout(void);
+    __attribute__((weak)) int proj_obj_fun_batch_checkout(void);
+
+    __attribute__((weak)) void obj_fun_batch_release(int mem);
+    __attribute__((weak)) void grad_fun_batch_release(int mem);
+    __attribute__((weak)) void proj_obj_fun_batch_release(int mem);
+
+    __attribute__((weak)) const casadi_int* obj_fun_batch_sparsity_in(casadi_int i);
+}
+
+/**
+ * @brief Lanes per call of the batched kernels; n_lanes in pgd_fun_gen.cpp
+ */
+constexpr size_t PGD_batch_lanes = 8;
+
+/**
+ * @brief Evaluation context for the batched kernels of pgd_fun_gen
+ *
+ * Checks out a memory slot of each batched kernel and allocates the
+ * largest work vectors once. available() is false when the archive has no
+ * batched kernels, or has them for another number of lanes.
+ */
+class PGD_batch_kernels {
+public:
+    PGD_batch_kernels() {
+        if (!(obj_fun_batch && grad_fun_batch && proj_obj_fun_batch))
+            return;
+        if (obj_fun_batch_sparsity_in(0)[0] != casadi_int(PGD_batch_lanes))
+            return;
+
+        mem[obj_k] = obj_fun_batch_checkout();
+        mem[grad_k] = grad_fun_batch_checkout();
+        mem[proj_obj_k] = proj_obj_fun_batch_checkout();
+
+        casadi_int sz[n_kernels][4] = {};
+        obj_fun_batch_work(&sz[obj_k][0], &sz[obj_k][1], &sz[obj_k][2], &sz[obj_k][3]);
+        grad_fun_batch_work(&sz[grad_k][0], &sz[grad_k][1], &sz[grad_k][2], &sz[grad_k][3]);
+        proj_obj_fun_batch_work(&sz[proj_obj_k][0], &sz[proj_obj_k][1], &sz[proj_obj_k][2], &sz[proj_obj_k][3]);
+        // At least the 4 inputs and 3 outputs of proj_obj_fun_batch
+        casadi_int sz_max[4] = {4, 3, 1, 1};
+        for (int i = 0; i < n_kernels; i++)
+            for (int j = 0; j < 4; j++) sz_max[j] = std::max(sz_max[j], sz[i][j]);
+        arg.resize(sz_max[0]);
+        res.resize(sz_max[1]);
+        iw.resize(sz_max[2]);
+        w.resize(sz_max[3]);
+        ok = true;
+    }
+
+    ~PGD_batch_kernels() {
+        if (!ok) return;
+        proj_obj_fun_batch_release(mem[proj_obj_k]);
+        grad_fun_batch_release(mem[grad_k]);
+        obj_fun_batch_release(mem[obj_k]);
+    }
+
+    PGD_batch_kernels(const PGD_batch_kernels&) = delete;
+    PGD_batch_kernels& operator=(const PGD_batch_kernels&) = delete;
+
+    bool available() const { return ok; }
+
+    /**
+     * @brief Objective at the lanes (x0[i], x1[i]), i < PGD_batch_lanes
+     */
+    void obj(const double* x0, const double* x1, double* f) {
+        arg[0] = x0; arg[1] = x1;
+        res[0] = f;
+        obj_fun_batch(arg.data(), res.data(), iw.data(), w.data(), mem[obj_k]);
+    }
+
+    /**
+     * @brief Gradient at the lanes, one output array per coordinate
+     */
+    void grad(const double* x0, const double* x1, double* grad0, double* grad1) {
+        arg[0] = x0; arg[1] = x1;
+        res[0] = grad0; res[1] = grad1;
+        grad_fun_batch(arg.data(), res.data(), iw.data(), w.data(), mem[grad_k]);
+    }
+
+    /**
+     * @brief Project the lanes onto the ball and evaluate the objective there
+     */
+    void proj_obj(const double* x0, const double* x1, const double C[2], const double& r,
+                  double* z0, double* z1, double* f) {
+        arg[0] = x0; arg[1] = x1; arg[2] = C; arg[3] = &r;
+        res[0] = z0; res[1] = z1; res[2] = f;
+        proj_obj_fun_batch(arg.data(), res.data(), iw.data(), w.data(), mem[proj_obj_k]);
+    }
+
+private:
+    enum { obj_k, grad_k, proj_obj_k, n_kernels };
+
+    bool ok = false;
+    int mem[n_kernels] = {};
+    std::vector<const double*> arg;
+    std::vector<double*> res;
+    std::vector<casadi_int> iw;
+    std::vector<double> w;
+};
+
+/**
+ * @brief Termination status of a single lane in PGD_API_batch
+ */
+enum class PGD_lane_status { running, converged, max_iter };
+
+/**
+ * @brief Batched multi-start PGD solver using the CasADi static library
+ *
+ * Runs the same nonmonotone accelerated PGD as PGD_API_s for K starting
+ * points. Lane state is stored as structure-of-arrays (one contiguous
+ * array per coordinate) so the update steps are plain element-wise loops
+ * the compiler can vectorize.
+ *
+ * The lanes are solved in blocks of PGD_batch_lanes, in lockstep within a
+ * block and one block after the other, so a block's state stays in cache
+ * and a block stops as soon as its own lanes are done. The kernels are the
+ * batched ones of pgd_fun_gen, which read and write the lane arrays
+ * directly, one block per call; only masked lanes take the results, so
+ * converged lanes stay frozen. With an archive without batched kernels
+ * every masked lane is evaluated by its own call of the single-point
+ * kernels.
+ *
+ * The lane arrays are padded to a multiple of PGD_batch_lanes; padding
+ * lanes are never masked.
+ */
+class PGD_API_batch {
+public:
+    /**
+     * @brief Constructor initializes the solver with default parameters
+     */
+    PGD_API_batch() {
+        C[0] = 0.0; C[1] = 1.2;
+        radius = 0.5;
+        eta = 0.4;
+        del = 0.001;
+        rho = 0.5;
+        max_iter = 100;
+        max_back_iter = 10;
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~PGD_API_batch() = default;
+
+    /**
+     * @brief Solve from every starting point in X_init
+     * @param X_init Initial guesses, one lane per entry
+     */
+    void solve(const std::vector<Eigen::Vector2d>& X_init) {
+        auto tic = std::chrono::high_resolution_clock::now();
+
+        resize(X_init.size());
+        for (size_t k = 0; k < K; k++) {
+            for (int d = 0; d < 2; d++) {
+                X[d][k] = X_init[k](d);
+                Y[d][k] = X[d][k];
+                X_prev[d][k] = X[d][k];
+                Y_prev[d][k] = 0.0;
+                grad_Y_prev[d][k] = 0.0;
+            }
+            alpha_last[k] = 1.0;
+            active[k] = 1;
+            status[k] = PGD_lane_status::running;
+            iters[k] = 0;
+        }
+
+        for (size_t b = 0; b < K; b += PGD_batch_lanes)
+            solve_block(b);
+
+        best = 0;
+        for (size_t k = 1; k < K; k++)
+            if (FX[k] < FX[best]) best = k;
+
+        auto toc = std::chrono::high_resolution_clock::now();
+        duration = toc - tic;
+    }
+
+    /**
+     * @brief Display the best lane and a status summary
+     */
+    void display_info() const {
+        size_t n_conv = 0;
+        for (size_t k = 0; k < K; k++)
+            n_conv += status[k] == PGD_lane_status::converged;
+        std::cout << "[PGD_API_batch] total time: " << duration.count() << "s" << std::endl;
+        std::cout << "[PGD_API_batch] lanes: " << K << ", converged: " << n_conv << std::endl;
+        std::cout << "[PGD_API_batch] kernels: "
+                  << (batch_kernels.available() ? "batched" : "one call per lane") << std::endl;
+        if (K == 0) return;
+        std::cout << "[PGD_API_batch] best lane: " << best << ", iter: " << iters[best]
+                  << ", objective: " << FX[best]
+                  << ", X: (" << X[0][best] << ", " << X[1][best] << ")" << std::endl;
+    }
+
+    size_t size() const { return K; }
+    bool batched_kernels() const { return batch_kernels.available(); }
+    size_t best_lane() const { return best; }
+
+    /**
+     * @brief Point and objective of the best lane
+     * @pre size() > 0: after solving an empty batch there is no best lane
+     */
+    Eigen::Vector2d best_X() const { assert(K > 0); return lane_X(best); }
+    double best_objective() const { assert(K > 0); return FX[best]; }
+
+    Eigen::Vector2d lane_X(size_t k) const { return Eigen::Vector2d(X[0][k], X[1][k]); }
+    double lane_objective(size_t k) const { return FX[k]; }
+    int lane_iter(size_t k) const { return iters[k]; }
+    PGD_lane_status lane_status(size_t k) const { return status[k]; }
+
+    std::chrono::duration<double> duration;
+
+private:
+    using lanes = std::vector<double>;
+    using mask = std::vector<unsigned char>;
+
+    static double sq(double a) { return a * a; }
+
+    void resize(size_t n) {
+        K = n;
+        size_t n_pad = (K + PGD_batch_lanes - 1) / PGD_batch_lanes * PGD_batch_lanes;
+        for (lanes* v : {X, Y, X_prev, Y_prev, grad_Y, grad_Y_prev, grad_X, Z, V, temp})
+            for (int d = 0; d < 2; d++) v[d].assign(n_pad, 0.0);
+        for (lanes* v : {&FX, &FZ, &FV, &ck, &alpha_Y, &alpha_X, &alpha_last})
+            v->assign(n_pad, 0.0);
+        active.assign(n_pad, 0);
+        retry.assign(n_pad, 0);
+        searching.assign(n_pad, 0);
+        back_iter.assign(n_pad, 0);
+        iters.assign(n_pad, 0);
+        status.assign(n_pad, PGD_lane_status::running);
+        best = 0;
+    }
+
+    /**
+     * @brief Run the lanes [b, b + PGD_batch_lanes) to completion
+     */
+    void solve_block(size_t b) {
+        const size_t e = b + PGD_batch_lanes;
+
+        evaluate_obj(b, X, FX, active);
+        size_t n_active = 0;
+        for (size_t k = b; k < e; k++) {
+            ck[k] = FX[k];
+            n_active += active[k];
+        }
+
+        double tk = 1.0, qk = 1.0;
+
+        for (int iter = 1; n_active > 0; iter++) {
+            evaluate_grad(b, Y, grad_Y, active);
+            bb_step(b, Y, grad_Y, alpha_Y, active);
+            line_search(b, Y, grad_Y, alpha_Y, Z, FZ, active);
+
+            // Lanes whose Z step is rejected also try a step from X
+            size_t n_retry = 0;
+            for (size_t k = b; k < e; k++) {
+                double dist = sq(Y[0][k] - Z[0][k]) + sq(Y[1][k] - Z[1][k]);
+                retry[k] = active[k] & ((ck[k] - FZ[k]) < del * dist);
+                n_retry += retry[k];
+            }
+
+            if (n_retry > 0) {
+                evaluate_grad(b, X, grad_X, retry);
+                bb_step(b, X, grad_X, alpha_X, retry);
+                line_search(b, X, grad_X, alpha_X, V, FV, retry);
+            }
+
+            for (size_t k = b; k < e; k++) {
+                if (!active[k]) continue;
+                bool take_V = retry[k] && FV[k] < FZ[k];
+                for (int d = 0; d < 2; d++)
+                    X[d][k] = take_V ? V[d][k] : Z[d][k];
+                FX[k] = take_V ? FV[k] : FZ[k];
+            }
+
+            double tk_plus = (1 + std::sqrt(1 + 4 * tk * tk)) / 2.0;
+            double qk_plus = eta * qk + 1;
+            double beta_Z = tk / tk_plus, beta_X = (tk - 1) / tk_plus;
+
+            for (size_t k = b; k < e; k++) {
+                if (!active[k]) continue;
+                double ck_plus = (eta * qk * ck[k] + FX[k]) / qk_plus;
+                bool done = sq(ck_plus - ck[k]) < 1e-6;
+                if (done || iter >= max_iter) {
+                    status[k] = done ? PGD_lane_status::converged : PGD_lane_status::max_iter;
+                    iters[k] = iter;
+                    active[k] = 0;
+                    n_active--;
+                    continue;
+                }
+                for (int d = 0; d < 2; d++) {
+                    Y_prev[d][k] = Y[d][k];
+                    grad_Y_prev[d][k] = grad_Y[d][k];
+                    Y[d][k] = X[d][k] + beta_Z * (Z[d][k] - X[d][k]) + beta_X * (X[d][k] - X_prev[d][k]);
+                    X_prev[d][k] = X[d][k];
+                }
+                ck[k] = ck_plus;
+            }
+
+            tk = tk_plus;
+            qk = qk_plus;
+        }
+    }
+
+    /**
+     * @brief Barzilai-Borwein step size against the previous Y iterate for
+     * the masked lanes of the block at b
+     *
+     * As in PGD_API_s, a zero gradient difference would give 0/0, so the
+     * lane reuses its last valid step instead.
+     */
+    void bb_step(size_t b, const lanes P[2], const lanes grad_P[2], lanes& alpha, const mask& m) {
+        for (size_t k = b; k < b + PGD_batch_lanes; k++) {
+            if (!m[k]) continue;
+            double s0 = P[0][k] - Y_prev[0][k], s1 = P[1][k] - Y_prev[1][k];
+            double r0 = grad_P[0][k] - grad_Y_prev[0][k], r1 = grad_P[1][k] - grad_Y_prev[1][k];
+            double denominator = r0 * r0 + r1 * r1;
+            if (denominator > 0)
+                alpha_last[k] = std::abs((s0 * r0 + s1 * r1) / denominator);
+            alpha[k] = alpha_last[k];
+        }
+    }
+
+    /**
+     * @brief Backtracking projected step from P for the masked lanes of the
+     * block at b
+     *
+     * All masked lanes take one trial step per pass; a lane leaves the
+     * search once its sufficient-decrease test holds or it runs out of
+     * backtracking steps.
+     */
+    void line_search(size_t b, const lanes P[2], const lanes grad_P[2], lanes& alpha,
+                     lanes out[2], lanes& F_out, const mask& lanes_in) {
+        const size_t e = b + PGD_batch_lanes;
+        size_t n_search = 0;
+        for (size_t k = b; k < e; k++) {
+            searching[k] = lanes_in[k];
+            back_iter[k] = 0;
+            n_search += searching[k];
+        }
+
+        while (n_search > 0) {
+            for (int d = 0; d < 2; d++)
+                for (size_t k = b; k < e; k++)
+                    temp[d][k] = P[d][k] - alpha[k] * grad_P[d][k];
+
+            evaluate_proj_obj(b, temp, out, F_out, searching);
+
+            for (size_t k = b; k < e; k++) {
+                if (!searching[k]) continue;
+                back_iter[k]++;
+                alpha[k] *= rho;
+                double dist = sq(Y[0][k] - out[0][k]) + sq(Y[1][k] - out[1][k]);
+                if ((ck[k] - F_out[k]) - del * dist >= 0 || back_iter[k] > max_back_iter) {
+                    searching[k] = 0;
+                    n_search--;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Evaluate objective function using CasADi for the masked lanes
+     * of the block at b
+     */
+    void evaluate_obj(size_t b, const lanes x[2], lanes& result, const mask& m) {
+        if (batch_kernels.available()) {
+            double f[PGD_batch_lanes];
+            batch_kernels.obj(&x[0][b], &x[1][b], f);
+            for (size_t i = 0; i < PGD_batch_lanes; i++)
+                if (m[b + i]) result[b + i] = f[i];
+            return;
+        }
+        double in[2];
+        for (size_t k = b; k < b + PGD_batch_lanes; k++) {
+            if (!m[k]) continue;
+            in[0] = x[0][k]; in[1] = x[1][k];
+            kernels.obj(in, result[k]);
+        }
+    }
+
+    /**
+     * @brief Evaluate gradient function using CasADi for the masked lanes
+     * of the block at b
+     */
+    void evaluate_grad(size_t b, const lanes x[2], lanes grad_out[2], const mask& m) {
+        if (batch_kernels.available()) {
+            double g0[PGD_batch_lanes], g1[PGD_batch_lanes];
+            batch_kernels.grad(&x[0][b], &x[1][b], g0, g1);
+            for (size_t i = 0; i < PGD_batch_lanes; i++) {
+                if (!m[b + i]) continue;
+                grad_out[0][b + i] = g0[i];
+                grad_out[1][b + i] = g1[i];
+            }
+            return;
+        }
+        double in[2], out[2];
+        for (size_t k = b; k < b + PGD_batch_lanes; k++) {
+            if (!m[k]) continue;
+            in[0] = x[0][k]; in[1] = x[1][k];
+            kernels.grad(in, out);
+            grad_out[0][k] = out[0]; grad_out[1][k] = out[1];
+        }
+    }
+
+    /**
+     * @brief Project and evaluate the objective at the projection for the
+     * masked lanes of the block at b
+     */
+    void evaluate_proj_obj(size_t b, const lanes input[2], lanes proj_out[2], lanes& result, const mask& m) {
+        if (batch_kernels.available()) {
+            double z0[PGD_batch_lanes], z1[PGD_batch_lanes], f[PGD_batch_lanes];
+            batch_kernels.proj_obj(&input[0][b], &input[1][b], C, radius, z0, z1, f);
+            for (size_t i = 0; i < PGD_batch_lanes; i++) {
+                if (!m[b + i]) continue;
+                proj_out[0][b + i] = z0[i];
+                proj_out[1][b + i] = z1[i];
+                result[b + i] = f[i];
+            }
+            return;
+        }
+        double in[2], out[2];
+        for (size_t k = b; k < b + PGD_batch_lanes; k++) {
+            if (!m[k]) continue;
+            in[0] = input[0][k]; in[1] = input[1][k];
+            kernels.proj_obj(in, C, radius, out, result[k]);
+            proj_out[0][k] = out[0]; proj_out[1][k] = out[1];
+        }
+    }
+
+    // Problem parameters
+    double C[2], radius;
+    double eta, del, rho;
+    int max_iter, max_back_iter;
+    PGD_kernels kernels;
+    PGD_batch_kernels batch_kernels;
+
+    // Lane state, one array per coordinate
+    size_t K = 0, best = 0;
+    lanes X[2], Y[2], X_prev[2], Y_prev[2];
+    lanes grad_Y[2], grad_Y_prev[2], grad_X[2];
+    lanes Z[2], V[2], temp[2];
+    lanes FX, FZ, FV, ck, alpha_Y, alpha_X, alpha_last;
+    mask active, retry, searching;
+    std::vector<int> back_iter, iters;
+    std::vector<PGD_lane_status> status;
+};
+
+#endif
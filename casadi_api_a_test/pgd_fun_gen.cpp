@@ -0,0 +1,79 @@
+// Generates pgd_fun.c and pgd_fun_f.c, the C sources of libpgd_fun.a, from
+// CasADi expressions. pgd_fun_f.c holds the same kernels with an _f suffix,
+// generated with casadi_real = float. pgd_fun.c also holds the *_batch
+// kernels of PGD_API_batch, which evaluate a block of lanes per call. The
+// CMake build runs this for the pgd_fun target; by hand:
+//
+//   ./pgd_fun_gen [output_dir]
+//   gcc -O3 -fPIC -c pgd_fun.c pgd_fun_f.c && ar rcs libpgd_fun.a pgd_fun.o pgd_fun_f.o
+
+#include <casadi/casadi.hpp>
+#include <iostream>
+
+using namespace casadi;
+
+int main(int argc, char* argv[]) {
+    std::string out_dir = argc > 1 ? argv[1] : ".";
+
+    SX x = SX::sym("x", 2);
+    SX C = SX::sym("C", 2);
+    SX r = SX::sym("r");
+
+    // 목적 함수: 15*(x1^2-1)^2 + 1*(x2^2-2)^2 + 4*x1*x2 + x1 + x2
+    SX f = 15.0*pow(x(0)*x(0)-1, 2) + 1.0*pow(x(1)*x(1) - 2, 2) + 4.0*x(0)*x(1) + x(0) + x(1);
+    SX grad_f = gradient(f, x);
+
+    // Projection onto the ball ||x - C|| <= r
+    SX d = x - C;
+    SX norm_d = norm_2(d);
+    SX z = if_else(norm_d > r, C + r * d / norm_d, x);
+    SX f_z = substitute(f, x, z);
+
+    // Batched kernels over n_lanes points in structure-of-arrays layout: each
+    // input and output is one coordinate over all lanes, so PGD_API_batch
+    // passes its lane arrays directly. Calling the mapped Functions on SX
+    // inlines every lane into one straight-line kernel.
+    const casadi_int n_lanes = 8;  // PGD_batch_lanes in pgd_api_batch.hpp
+    SX x0 = SX::sym("x0", n_lanes), x1 = SX::sym("x1", n_lanes);
+    SX x_lanes = horzcat(x0, x1).T();
+    SX f_lanes = Function("obj", {x}, {f}).map(n_lanes)(std::vector<SX>{x_lanes})[0].T();
+    SX g_lanes = Function("grad", {x}, {grad_f}).map(n_lanes)(std::vector<SX>{x_lanes})[0];
+    std::vector<SX> zf_lanes = Function("proj_obj", {x, C, r}, {z, f_z}).map(n_lanes)(
+        std::vector<SX>{x_lanes, repmat(C, 1, n_lanes), repmat(r, 1, n_lanes)});
+
+    Function obj_fun_batch("obj_fun_batch", {x0, x1}, {f_lanes}, {"x0", "x1"}, {"f"});
+    Function grad_fun_batch("grad_fun_batch", {x0, x1}, {g_lanes(0, Slice()).T(), g_lanes(1, Slice()).T()},
+                            {"x0", "x1"}, {"grad0", "grad1"});
+    Function proj_obj_fun_batch("proj_obj_fun_batch", {x0, x1, C, r},
+                                {zf_lanes[0](0, Slice()).T(), zf_lanes[0](1, Slice()).T(), zf_lanes[1].T()},
+                                {"x0", "x1", "C", "r"}, {"z0", "z1", "f"});
+
+    // obj_fun, grad_fun, proj_fun and the fused kernels, names ending in
+    // suffix, followed by the extra Functions
+    auto generate = [&](const std::string& file, const std::string& suffix, const Dict& opts,
+                        const std::vector<Function>& extra) {
+        Function obj_fun("obj_fun" + suffix, {x}, {f}, {"x"}, {"f"});
+        Function grad_fun("grad_fun" + suffix, {x}, {grad_f}, {"x"}, {"grad"});
+        Function proj_fun("proj_fun" + suffix, {x, C, r}, {z}, {"x", "C", "r"}, {"z"});
+
+        // Fused kernels: shared subexpressions are evaluated once per call
+        Function obj_grad_fun("obj_grad_fun" + suffix, {x}, {f, grad_f}, {"x"}, {"f", "grad"});
+        Function proj_obj_fun("proj_obj_fun" + suffix, {x, C, r}, {z, f_z}, {"x", "C", "r"}, {"z", "f"});
+
+        CodeGenerator cg(file, opts);
+        cg.add(obj_fun);
+        cg.add(grad_fun);
+        cg.add(proj_fun);
+        cg.add(obj_grad_fun);
+        cg.add(proj_obj_fun);
+        for (const Function& fn : extra) cg.add(fn);
+        return cg.generate(out_dir + "/");
+    };
+
+    std::string file = generate("pgd_fun.c", "", Dict{{"with_header", true}},
+                                {obj_fun_batch, grad_fun_batch, proj_obj_fun_batch});
+    std::string file_f = generate("pgd_fun_f.c", "_f", Dict{{"with_header", true}, {"casadi_real", "float"}}, {});
+
+    std::cout << "Generated " << file << " and " << file_f << std::endl;
+    return 0;
+}
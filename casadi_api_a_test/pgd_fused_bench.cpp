@@ -0,0 +1,52 @@
+#include "casadi_api_a_test.hpp"
+#include <vector>
+#include <random>
+
+int main () {
+    const int n_points = 4096;
+    const int n_rep = 200;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> start(-2.0, 2.0);
+    std::vector<double> pts(2 * n_points);
+    for (auto& p : pts) p = start(gen);
+
+    const double C[2] = {0.0, 1.2};
+    const double radius = 0.5;
+    double out[2], grad[2], f, sink = 0.0;
+
+    PGD_kernels kernels;
+    if (!kernels.has_fused())
+        std::cout << "[PGD_kernels] libpgd_fun.a has no fused kernels, "
+                     "regenerate it with pgd_fun_gen; timing the fallback" << std::endl;
+
+    auto time_it = [&](const char* name, auto&& body) {
+        auto tic = std::chrono::high_resolution_clock::now();
+        for (int rep = 0; rep < n_rep; rep++)
+            for (int i = 0; i < n_points; i++) body(&pts[2 * i]);
+        auto toc = std::chrono::high_resolution_clock::now();
+        double t = std::chrono::duration<double>(toc - tic).count();
+        std::cout << "[" << name << "] evals/s: " << double(n_rep) * n_points / t << std::endl;
+    };
+
+    time_it("proj_fun + obj_fun", [&](const double* x) {
+        kernels.proj(x, C, radius, out);
+        kernels.obj(out, f);
+        sink += f;
+    });
+    time_it("proj_obj_fun", [&](const double* x) {
+        kernels.proj_obj(x, C, radius, out, f);
+        sink += f;
+    });
+    time_it("obj_fun + grad_fun", [&](const double* x) {
+        kernels.obj(x, f);
+        kernels.grad(x, grad);
+        sink += f + grad[0];
+    });
+    time_it("obj_grad_fun", [&](const double* x) {
+        kernels.obj_grad(x, f, grad);
+        sink += f + grad[0];
+    });
+
+    std::cout << "checksum: " << sink << std::endl;
+}
@@ -0,0 +1,152 @@
+#ifndef PGD_POOL_HPP
+#define PGD_POOL_HPP
+
+#include "casadi_api_a_test.hpp"
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @brief One independent PGD solve: start point and projection ball
+ */
+struct PGD_problem {
+    Eigen::Vector2d X_init;
+    Eigen::Vector2d C = Eigen::Vector2d(0.0, 1.2);
+    double radius = 0.5;
+};
+
+/**
+ * @brief Result of one PGD solve
+ */
+struct PGD_solution {
+    Eigen::Vector2d X;
+    double FX;
+    int iter;
+};
+
+/**
+ * @brief Thread pool running independent PGD_API_s solves
+ *
+ * Every worker owns one PGD_API_s (and therefore its own kernel memory
+ * slots). solve_many() splits the problem list into one contiguous range
+ * per worker; a worker that finishes its range steals the remaining
+ * problems of the other ranges one at a time.
+ */
+class PGD_pool {
+public:
+    /**
+     * @brief Start the worker threads
+     * @param n_threads Number of workers, 0 selects hardware_concurrency()
+     */
+    explicit PGD_pool(unsigned n_threads = 0) {
+        if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+        n_workers = n_threads;
+        ranges = std::unique_ptr<range[]>(new range[n_threads]);
+        for (unsigned t = 0; t < n_threads; t++)
+            workers.emplace_back([this, t] { worker_loop(t); });
+    }
+
+    /**
+     * @brief Stop and join the worker threads
+     */
+    ~PGD_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv_start.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    PGD_pool(const PGD_pool&) = delete;
+    PGD_pool& operator=(const PGD_pool&) = delete;
+
+    unsigned size() const { return n_workers; }
+
+    /**
+     * @brief Solve all problems and block until every result is written
+     * @param problems Pointer to the first problem
+     * @param n Number of problems
+     * @param out Output array of n solutions
+     */
+    void solve_many(const PGD_problem* problems, size_t n, PGD_solution* out) {
+        std::unique_lock<std::mutex> lock(mtx);
+        job_problems = problems;
+        job_out = out;
+
+        unsigned n_threads = size();
+        for (unsigned t = 0; t < n_threads; t++) {
+            ranges[t].next.store(n * t / n_threads, std::memory_order_relaxed);
+            ranges[t].end = n * (t + 1) / n_threads;
+        }
+        busy = n_threads;
+        generation++;
+        cv_start.notify_all();
+        cv_done.wait(lock, [this] { return busy == 0; });
+    }
+
+    /**
+     * @brief Convenience overload returning a vector of solutions
+     */
+    std::vector<PGD_solution> solve_many(const std::vector<PGD_problem>& problems) {
+        std::vector<PGD_solution> out(problems.size());
+        solve_many(problems.data(), problems.size(), out.data());
+        return out;
+    }
+
+private:
+    struct alignas(64) range {
+        std::atomic<size_t> next{0};
+        size_t end = 0;
+    };
+
+    void worker_loop(unsigned t) {
+        PGD_API_s solver;
+        unsigned seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv_start.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+
+            // Own range first, then steal from the others
+            unsigned n_threads = size();
+            for (unsigned v = 0; v < n_threads; v++) {
+                range& r = ranges[(t + v) % n_threads];
+                size_t i;
+                while ((i = r.next.fetch_add(1, std::memory_order_relaxed)) < r.end)
+                    run(solver, i);
+            }
+
+            std::lock_guard<std::mutex> lock(mtx);
+            if (--busy == 0) cv_done.notify_one();
+        }
+    }
+
+    void run(PGD_API_s& solver, size_t i) {
+        const PGD_problem& p = job_problems[i];
+        solver.set_problem(p.C, p.radius);
+        solver.solve(p.X_init);
+        job_out[i] = PGD_solution{solver.solution(), solver.objective(), solver.iterations()};
+    }
+
+    unsigned n_workers;
+    std::vector<std::thread> workers;
+    std::unique_ptr<range[]> ranges;
+
+    std::mutex mtx;
+    std::condition_variable cv_start, cv_done;
+    unsigned generation = 0, busy = 0;
+    bool stopping = false;
+
+    const PGD_problem* job_problems = nullptr;
+    PGD_solution* job_out = nullptr;
+};
+
+#endif
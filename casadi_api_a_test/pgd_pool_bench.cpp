@@ -0,0 +1,40 @@
+#include "pgd_pool.hpp"
+#include <random>
+
+int main () {
+    const size_t n_problems = 20000;
+    const int n_rep = 5;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> start(-2.0, 2.0);
+    std::vector<PGD_problem> problems(n_problems);
+    for (auto& p : problems) p.X_init = Eigen::Vector2d(start(gen), start(gen));
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    double t_single = 0.0;
+
+    // 1, 2, 4, ... and max_threads itself when it is not a power of two
+    std::vector<unsigned> thread_counts;
+    for (unsigned n = 1; n < max_threads; n *= 2) thread_counts.push_back(n);
+    thread_counts.push_back(max_threads);
+
+    for (unsigned n_threads : thread_counts) {
+        PGD_pool pool(n_threads);
+        std::vector<PGD_solution> sol(n_problems);
+        pool.solve_many(problems.data(), n_problems, sol.data());  // warmup
+
+        double best = 1e300;
+        for (int rep = 0; rep < n_rep; rep++) {
+            auto tic = std::chrono::high_resolution_clock::now();
+            pool.solve_many(problems.data(), n_problems, sol.data());
+            auto toc = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double>(toc - tic).count());
+        }
+        if (n_threads == 1) t_single = best;
+
+        std::cout << "[PGD_pool] threads: " << n_threads
+                  << ", time: " << best << "s"
+                  << ", solves/s: " << n_problems / best
+                  << ", speedup: " << t_single / best << std::endl;
+    }
+}
@@ -0,0 +1,102 @@
+#include "casadi_api_a_test.hpp"
+#include <vector>
+#include <random>
+#include <cmath>
+
+int main () {
+    const int n_points = 4096;
+    const int n_rep = 200;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> start(-2.0, 2.0);
+    std::vector<double> pts(2 * n_points);
+    for (auto& p : pts) p = start(gen);
+    std::vector<float> pts_f(pts.begin(), pts.end());
+
+    PGD_kernels kernels;
+    PGD_kernels_t<float> kernels_f;
+    if (!kernels_f.available()) {
+        std::cout << "[PGD_kernels] libpgd_fun.a has no float kernels, "
+                     "regenerate it with pgd_fun_gen" << std::endl;
+        return 0;
+    }
+
+    // ---- kernel throughput ----
+    auto time_it = [&](const char* name, auto&& body) {
+        auto tic = std::chrono::high_resolution_clock::now();
+        for (int rep = 0; rep < n_rep; rep++)
+            for (int i = 0; i < n_points; i++) body(i);
+        auto toc = std::chrono::high_resolution_clock::now();
+        double t = std::chrono::duration<double>(toc - tic).count();
+        std::cout << "[" << name << "] evals/s: " << double(n_rep) * n_points / t << std::endl;
+    };
+
+    const double C[2] = {0.0, 1.2};
+    const double radius = 0.5;
+    const float C_f[2] = {0.0f, 1.2f};
+    const float radius_f = 0.5f;
+    double out[2], grad[2], f, sink = 0.0;
+    float out_f[2], grad_f[2], f_f;
+
+    time_it("obj_grad_fun", [&](int i) {
+        kernels.obj_grad(&pts[2 * i], f, grad);
+        sink += f + grad[0];
+    });
+    time_it("obj_grad_fun_f", [&](int i) {
+        kernels_f.obj_grad(&pts_f[2 * i], f_f, grad_f);
+        sink += f_f + grad_f[0];
+    });
+    time_it("proj_obj_fun", [&](int i) {
+        kernels.proj_obj(&pts[2 * i], C, radius, out, f);
+        sink += f;
+    });
+    time_it("proj_obj_fun_f", [&](int i) {
+        kernels_f.proj_obj(&pts_f[2 * i], C_f, radius_f, out_f, f_f);
+        sink += f_f;
+    });
+
+    // ---- solves: throughput and accuracy ----
+    // The starts reach different local minima, so accuracy is measured by the
+    // projected-gradient residual ||x - P(x - grad f(x))|| in double
+    auto residual = [&](const Eigen::Vector2d& x) {
+        double g[2], step[2], p[2];
+        kernels.grad(x.data(), g);
+        step[0] = x(0) - g[0]; step[1] = x(1) - g[1];
+        kernels.proj(step, C, radius, p);
+        return std::hypot(x(0) - p[0], x(1) - p[1]);
+    };
+
+    const struct { const char* name; PGD_precision p; } modes[] = {
+        {"double", PGD_precision::double_only},
+        {"float", PGD_precision::float_only},
+        {"mixed", PGD_precision::mixed}};
+
+    PGD_API_s solver;
+    for (const auto& mode : modes) {
+        solver.set_precision(mode.p);
+        double iters = 0, float_iters = 0;
+        std::vector<double> res(n_points);
+        std::vector<Eigen::Vector2d> X(n_points);
+
+        auto tic = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < n_points; i++) {
+            solver.solve(Eigen::Vector2d(pts[2 * i], pts[2 * i + 1]));
+            iters += solver.iterations();
+            float_iters += solver.float_iterations();
+            X[i] = solver.solution();
+        }
+        auto toc = std::chrono::high_resolution_clock::now();
+        double t = std::chrono::duration<double>(toc - tic).count();
+
+        for (int i = 0; i < n_points; i++) res[i] = residual(X[i]);
+        std::sort(res.begin(), res.end());
+
+        std::cout << "[PGD_API_s " << mode.name << "] solves/s: " << n_points / t
+                  << ", iter: " << iters / n_points
+                  << " (float " << float_iters / n_points << ")"
+                  << ", residual p50: " << res[n_points / 2]
+                  << ", p99: " << res[n_points * 99 / 100] << std::endl;
+    }
+
+    std::cout << "checksum: " << sink << std::endl;
+}
@@ -0,0 +1,114 @@
+#ifndef PGD_TELEMETRY_HPP
+#define PGD_TELEMETRY_HPP
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <matio.h>
+
+/**
+ * @brief Accepted branch of a PGD iteration
+ */
+enum class PGD_branch : std::int8_t { Z = 0, V = 1 };
+
+/**
+ * @brief Per-iteration telemetry of PGD_API_s
+ *
+ * Fixed-capacity ring buffer stored as one array per field, allocated once
+ * in the constructor. record() only stores values and advances the head, so
+ * it can be called inside the solver loop; when more than capacity()
+ * iterations are recorded the oldest ones are overwritten. Timestamps are
+ * nanoseconds since begin().
+ *
+ * save_mat() writes the recorded iterations in chronological order as
+ * column vectors to a MAT file.
+ */
+class PGD_telemetry {
+public:
+    explicit PGD_telemetry(size_t capacity = 1024)
+        : cap(capacity), FX(capacity), ck(capacity), alpha_Y(capacity), alpha_X(capacity),
+          iter(capacity), back_iter(capacity), mon_iter(capacity), branch(capacity), t_ns(capacity) {}
+
+    /**
+     * @brief Start a new solve: clear the buffer and reset the time origin
+     */
+    void begin() {
+        head = 0;
+        count = 0;
+        t0 = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Store one iteration
+     */
+    void record(int k, double fx, double c, double a_Y, double a_X,
+                int n_back, int n_mon, PGD_branch b) {
+        FX[head] = fx;
+        ck[head] = c;
+        alpha_Y[head] = a_Y;
+        alpha_X[head] = a_X;
+        iter[head] = k;
+        back_iter[head] = n_back;
+        mon_iter[head] = n_mon;
+        branch[head] = static_cast<std::int8_t>(b);
+        t_ns[head] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - t0).count();
+        if (++head == cap) head = 0;
+        count++;
+    }
+
+    size_t capacity() const { return cap; }
+    size_t size() const { return count < cap ? count : cap; }
+    bool wrapped() const { return count > cap; }
+
+    /**
+     * @brief Write the recorded iterations to a MAT file
+     * @param filename Output file, overwritten if it exists
+     */
+    void save_mat(const std::string& filename) const {
+        mat_t* matfp = Mat_CreateVer(filename.c_str(), NULL, MAT_FT_MAT5);
+        if (!matfp) throw std::runtime_error("Failed to create " + filename);
+
+        write_var(matfp, "FX", MAT_C_DOUBLE, MAT_T_DOUBLE, FX);
+        write_var(matfp, "ck", MAT_C_DOUBLE, MAT_T_DOUBLE, ck);
+        write_var(matfp, "alpha_Y", MAT_C_DOUBLE, MAT_T_DOUBLE, alpha_Y);
+        write_var(matfp, "alpha_X", MAT_C_DOUBLE, MAT_T_DOUBLE, alpha_X);
+        write_var(matfp, "iter", MAT_C_INT32, MAT_T_INT32, iter);
+        write_var(matfp, "back_iter", MAT_C_INT32, MAT_T_INT32, back_iter);
+        write_var(matfp, "mon_iter", MAT_C_INT32, MAT_T_INT32, mon_iter);
+        write_var(matfp, "branch", MAT_C_INT8, MAT_T_INT8, branch);
+        write_var(matfp, "t_ns", MAT_C_INT64, MAT_T_INT64, t_ns);
+
+        Mat_Close(matfp);
+    }
+
+private:
+    // Copy a field into chronological order and write it as an n x 1 variable
+    template <class T>
+    void write_var(mat_t* matfp, const char* name, matio_classes class_type,
+                   matio_types data_type, const std::vector<T>& field) const {
+        size_t n = size();
+        size_t first = wrapped() ? head : 0;
+        std::vector<T> column(n);
+        for (size_t i = 0; i < n; i++) column[i] = field[(first + i) % cap];
+
+        size_t dims[2] = {n, 1};
+        matvar_t* matvar = Mat_VarCreate(name, class_type, data_type, 2, dims, column.data(), 0);
+        if (!matvar) throw std::runtime_error("Failed to create matvar");
+        Mat_VarWrite(matfp, matvar, MAT_COMPRESSION_NONE);
+        Mat_VarFree(matvar);
+    }
+
+    size_t cap;
+    size_t head = 0, count = 0;
+    std::chrono::steady_clock::time_point t0;
+
+    std::vector<double> FX, ck, alpha_Y, alpha_X;
+    std::vector<std::int32_t> iter, back_iter, mon_iter;
+    std::vector<std::int8_t> branch;
+    std::vector<std::int64_t> t_ns;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "ipopt_recorder.h"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+
+using recorder_clock = std::chrono::steady_clock;
+
+// Iteration callback of the NLP solver: stores the time of each call and
+// lets Ipopt continue. Its inputs are the nlpsol outputs (x, f, g, lam_*).
+class Ipopt_recorder::Iteration_callback : public casadi::Callback {
+public:
+  Iteration_callback(casadi::casadi_int nx, casadi::casadi_int ng, casadi::casadi_int np, int max_iter)
+      : nx(nx), ng(ng), np(np) {
+    t.reserve(max_iter + 1);
+    construct("ipopt_recorder");
+  }
+
+  casadi::casadi_int get_n_in() override { return casadi::nlpsol_n_out(); }
+  casadi::casadi_int get_n_out() override { return 1; }
+  std::string get_name_in(casadi::casadi_int i) override { return casadi::nlpsol_out(i); }
+  std::string get_name_out(casadi::casadi_int i) override { return "ret"; }
+
+  casadi::Sparsity get_sparsity_in(casadi::casadi_int i) override {
+    std::string n = casadi::nlpsol_out(i);
+    if (n == "f") return casadi::Sparsity::scalar();
+    if (n == "x" || n == "lam_x") return casadi::Sparsity::dense(nx);
+    if (n == "g" || n == "lam_g") return casadi::Sparsity::dense(ng);
+    if (n == "lam_p") return casadi::Sparsity::dense(np);
+    return casadi::Sparsity(0, 0);
+  }
+
+  std::vector<casadi::DM> eval(const std::vector<casadi::DM>&) const override {
+    t.push_back(recorder_clock::now());
+    return {casadi::DM(0)};
+  }
+
+  recorder_clock::time_point t0;
+  mutable std::vector<recorder_clock::time_point> t;
+
+private:
+  casadi::casadi_int nx, ng, np;
+};
+
+Ipopt_recorder::Ipopt_recorder(casadi::casadi_int nx, casadi::casadi_int ng, casadi::casadi_int np,
+                               const std::string& timing_file, int max_iter)
+    : callback(new Iteration_callback(nx, ng, np, max_iter)), timing_file(timing_file) {}
+
+Ipopt_recorder::~Ipopt_recorder() = default;
+
+casadi::Dict Ipopt_recorder::options(casadi::Dict opts) const {
+  opts["print_time"] = false;
+  opts["ipopt.print_level"] = 0;
+  opts["ipopt.sb"] = "yes";
+  // Timing statistics are printed at summary level (3); the iteration table
+  // (level 5) stays out of the log file
+  opts["ipopt.timing_statistics"] = "yes";
+  opts["ipopt.output_file"] = timing_file;
+  opts["ipopt.file_print_level"] = 3;
+  opts["iteration_callback"] = *callback;
+  return opts;
+}
+
+void Ipopt_recorder::start() {
+  callback->t.clear();
+  callback->t0 = recorder_clock::now();
+}
+
+// Wall time of an entry of the last Ipopt timing statistics table, -1 if absent
+//   " LinearSystemFactorization..........:      0.001 (sys:      0.000 wall:      0.001)"
+static double timing_entry(const std::string& log, const std::string& name) {
+  size_t pos = log.rfind(" " + name + ".");
+  if (pos == std::string::npos) return -1;
+  size_t eol = log.find('\n', pos);
+  size_t wall = log.find("wall:", pos);
+  if (wall == std::string::npos || wall > eol) return -1;
+  return std::strtod(log.c_str() + wall + 5, nullptr);
+}
+
+void Ipopt_recorder::finish(const casadi::Dict& stats) {
+  t_wall.clear();
+  for (const auto& t : callback->t)
+    t_wall.push_back(std::chrono::duration<double>(t - callback->t0).count());
+
+  std::vector<std::pair<const char*, std::vector<double>*>> fields = {
+    {"obj", &obj}, {"inf_pr", &inf_pr}, {"inf_du", &inf_du}, {"mu", &mu}, {"d_norm", &d_norm},
+    {"alpha_pr", &alpha_pr}, {"alpha_du", &alpha_du}, {"ls_trials", &ls_trials}};
+  casadi::Dict iterations;
+  if (stats.count("iterations")) iterations = stats.at("iterations").as_dict();
+  for (auto& f : fields)
+    *f.second = iterations.count(f.first) ? iterations.at(f.first).to_double_vector()
+                                          : std::vector<double>();
+
+  iter_count = stats.count("iter_count") ? stats.at("iter_count").as_int() : 0;
+  return_status = stats.count("return_status") ? stats.at("return_status").as_string() : "";
+  t_total = stats.count("t_wall_total") ? stats.at("t_wall_total").as_double() : 0;
+
+  // t_wall_nlp_* are the NLP callbacks (f, g, gradients, Jacobian, Hessian)
+  t_nlp = 0;
+  t_parts.clear();
+  for (const auto& s : stats) {
+    if (s.first.rfind("t_wall_nlp_", 0) != 0) continue;
+    t_parts.emplace_back(s.first.substr(7), s.second.as_double());
+    t_nlp += s.second.as_double();
+  }
+
+  std::ifstream file(timing_file);
+  std::stringstream log;
+  log << file.rdbuf();
+  t_linsol_fact = timing_entry(log.str(), "LinearSystemFactorization");
+  t_linsol_solve = timing_entry(log.str(), "LinearSystemBackSolve");
+}
+
+void Ipopt_recorder::save_mat(const std::string& filename) const {
+  Mat_writer out(filename, false, MAT_FT_MAT5);
+  write(out);
+}
+
+// Per-iteration columns and the time totals, names prefixed with prefix
+void Ipopt_recorder::write(Mat_writer& out, const std::string& prefix) const {
+  auto column = [&](const char* name, const std::vector<double>& v) {
+    out.write(prefix + name, v.data(), v.size(), 1);
+  };
+  column("t_wall", t_wall);
+  column("obj", obj);
+  column("inf_pr", inf_pr);
+  column("inf_du", inf_du);
+  column("mu", mu);
+  column("d_norm", d_norm);
+  column("alpha_pr", alpha_pr);
+  column("alpha_du", alpha_du);
+  column("ls_trials", ls_trials);
+  out.write(prefix + "t_total", t_total);
+  out.write(prefix + "t_nlp", t_nlp);
+  out.write(prefix + "t_linsol", t_linsol_fact + t_linsol_solve);
+}
+
+void Ipopt_recorder::print_summary(std::ostream& out) const {
+  auto share = [this](double t) { return t_total > 0 ? 100 * t / t_total : 0.0; };
+  out << std::fixed << std::setprecision(4);
+  out << "Ipopt: " << iter_count << " iterations, " << return_status << std::endl;
+  out << "  total          " << std::setw(10) << t_total << " s" << std::endl;
+  out << "  NLP callbacks  " << std::setw(10) << t_nlp << " s ("
+      << std::setprecision(1) << share(t_nlp) << " %)" << std::setprecision(4) << std::endl;
+  for (const auto& p : t_parts)
+    out << "    " << std::setw(14) << std::left << p.first << std::right
+        << std::setw(8) << p.second << " s" << std::endl;
+  if (t_linsol_fact >= 0 && t_linsol_solve >= 0) {
+    double t_linsol = t_linsol_fact + t_linsol_solve;
+    out << "  linear solver  " << std::setw(10) << t_linsol << " s ("
+        << std::setprecision(1) << share(t_linsol) << " %)" << std::setprecision(4)
+        << ", factorization " << t_linsol_fact << " s, backsolve " << t_linsol_solve << " s" << std::endl;
+    out << "  rest of Ipopt  " << std::setw(10) << t_total - t_nlp - t_linsol << " s" << std::endl;
+  } else {
+    out << "  linear solver  n/a (no timing statistics in " << timing_file << ")" << std::endl;
+  }
+  out << std::defaultfloat;
+}
@@ -0,0 +1,62 @@
+#ifndef IPOPT_RECORDER_H
+#define IPOPT_RECORDER_H
+
+#include <casadi/casadi.hpp>
+#include "mat_writer.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Ipopt iteration log without console output
+//
+// options() turns off the Ipopt console output and installs an iteration
+// callback that only stores a timestamp per iteration. finish() takes the
+// per-iteration values (objective, infeasibilities, mu, step sizes) from the
+// solver stats and the linear solver time from Ipopt's timing statistics,
+// which go to a log file at summary level instead of the console.
+//
+//   Ipopt_recorder rec(opti.nx(), opti.ng(), opti.np());
+//   opti.solver("ipopt", rec.options());
+//   rec.start();
+//   OptiSol sol = opti.solve();
+//   rec.finish(sol.stats());
+//   rec.save_mat("ipopt_log.mat");
+//   rec.print_summary();
+class Ipopt_recorder {
+public:
+  Ipopt_recorder(casadi::casadi_int nx, casadi::casadi_int ng, casadi::casadi_int np = 0,
+                 const std::string& timing_file = "ipopt_timing.log", int max_iter = 3000);
+  ~Ipopt_recorder();
+
+  Ipopt_recorder(const Ipopt_recorder&) = delete;
+  Ipopt_recorder& operator=(const Ipopt_recorder&) = delete;
+
+  // opts with the quiet-output, timing and iteration callback options added
+  casadi::Dict options(casadi::Dict opts = casadi::Dict()) const;
+
+  void start();
+  void finish(const casadi::Dict& stats);
+
+  void save_mat(const std::string& filename) const;
+  void write(Mat_writer& out, const std::string& prefix = "") const;
+  void print_summary(std::ostream& out = std::cout) const;
+
+  int iterations() const { return iter_count; }
+
+private:
+  class Iteration_callback;
+  std::unique_ptr<Iteration_callback> callback;
+  std::string timing_file;
+
+  // Per iteration, index 0 is the initial point
+  std::vector<double> t_wall, obj, inf_pr, inf_du, mu, d_norm, alpha_pr, alpha_du, ls_trials;
+
+  // Summary of the last solve
+  int iter_count = 0;
+  std::string return_status;
+  double t_total = 0, t_nlp = 0, t_linsol_fact = -1, t_linsol_solve = -1;
+  std::vector<std::pair<std::string, double>> t_parts;
+};
+
+#endif
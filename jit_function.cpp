@@ -0,0 +1,97 @@
+#include "jit_function.h"
+#include "solver_cache.h"
+#include <dlfcn.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+Jit_function::Jit_function(const casadi::Function& f, const std::string& cache_dir,
+                           const std::string& compiler)
+    : name(f.name()), n_in(f.n_in()), n_out(f.n_out()) {
+  std::ostringstream desc;
+  desc << compiler << '\n' << casadi::CasadiMeta::version() << '\n';
+  std::string stem = name + "_" + cache_key(desc.str() + f.serialize());
+  fs::path lib = fs::path(cache_dir) / (stem + ".so");
+  library_file = lib.string();
+
+  if (!fs::exists(lib)) {
+    // Generate and compile under names private to this build, then rename:
+    // concurrent builds, in other processes or threads, never share a source
+    // or a partial library, and the rename is atomic, so a loader sees either
+    // no file or the whole library
+    fs::create_directories(cache_dir);
+    static std::atomic<unsigned> n_compiled{0};
+    std::string tag = stem + "_" + std::to_string(getpid()) + "_" + std::to_string(n_compiled++);
+    casadi::CodeGenerator cg(tag + ".c");
+    cg.add(f);
+    std::string src = cg.generate(cache_dir + "/");
+
+    fs::path tmp = fs::path(cache_dir) / (tag + ".so.tmp");
+    std::string cmd = compiler + " " + src + " -o " + tmp.string();
+    int status = std::system(cmd.c_str());
+    fs::remove(src);
+    if (status != 0) {
+      fs::remove(tmp);
+      throw std::runtime_error("Jit_function: compilation failed: " + cmd);
+    }
+    fs::rename(tmp, lib);
+    compiled = true;
+  }
+
+  handle = dlopen(library_file.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!handle) throw std::runtime_error(std::string("Jit_function: ") + dlerror());
+
+  Ref incref_fn;
+  Checkout checkout_fn;
+  Work work_fn;
+  try {
+    eval_fn = reinterpret_cast<Eval>(symbol(""));
+    release_fn = reinterpret_cast<Release>(symbol("_release"));
+    incref_fn = reinterpret_cast<Ref>(symbol("_incref"));
+    decref_fn = reinterpret_cast<Ref>(symbol("_decref"));
+    checkout_fn = reinterpret_cast<Checkout>(symbol("_checkout"));
+    work_fn = reinterpret_cast<Work>(symbol("_work"));
+  } catch (...) {
+    dlclose(handle);
+    throw;
+  }
+  incref_fn();
+  mem = checkout_fn();
+
+  casadi::casadi_int sz_arg, sz_res, sz_iw, sz_w;
+  work_fn(&sz_arg, &sz_res, &sz_iw, &sz_w);
+  arg_buf.resize(std::max(sz_arg, n_in));
+  res_buf.resize(std::max(sz_res, n_out));
+  iw.resize(sz_iw);
+  w.resize(sz_w);
+}
+
+Jit_function::~Jit_function() {
+  if (!handle) return;
+  release_fn(mem);
+  decref_fn();
+  dlclose(handle);
+}
+
+void* Jit_function::symbol(const std::string& suffix) const {
+  void* s = dlsym(handle, (name + suffix).c_str());
+  if (!s)
+    throw std::runtime_error("Jit_function: " + name + suffix + " not found in " + library_file);
+  return s;
+}
+
+int Jit_function::eval(const double* const* arg, double* const* res) {
+  for (casadi::casadi_int i = 0; i < n_in; ++i) arg_buf[i] = arg[i];
+  for (casadi::casadi_int i = 0; i < n_out; ++i) res_buf[i] = res[i];
+  return eval_fn(arg_buf.data(), res_buf.data(), iw.data(), w.data(), mem);
+}
+
+casadi::Function Jit_function::external() const {
+  return casadi::external(name, library_file);
+}
@@ -0,0 +1,67 @@
+#ifndef JIT_FUNCTION_H
+#define JIT_FUNCTION_H
+
+#include <casadi/casadi.hpp>
+#include <string>
+#include <vector>
+
+// Native evaluation of a CasADi Function through a cached shared object
+//
+// The first construction for a given Function generates its C code, compiles
+// it with the system compiler to cache_dir/<name>_<key>.so and loads it; later
+// constructions, also from later runs, load that file directly. The key hashes
+// the serialized Function, the compiler command and the CasADi version, so a
+// changed expression never picks up a stale library.
+//
+// eval() calls the generated entry point with work vectors allocated once in
+// the constructor: no DM temporaries, no virtual machine, no allocation.
+// Inputs and outputs are the dense nonzeros of each argument.
+//
+//   Jit_function f_jit(f_eval);
+//   const double* arg[] = {x};
+//   double* res[] = {&f};
+//   f_jit.eval(arg, res);
+class Jit_function {
+public:
+  explicit Jit_function(const casadi::Function& f, const std::string& cache_dir = "jit_cache",
+                        const std::string& compiler = "gcc -O3 -fPIC -shared");
+  ~Jit_function();
+
+  Jit_function(const Jit_function&) = delete;
+  Jit_function& operator=(const Jit_function&) = delete;
+
+  // arg[i] / res[i] point to input / output i; a null res[i] skips output i
+  int eval(const double* const* arg, double* const* res);
+
+  // The same library behind a CasADi Function, for the DM/MX call interface
+  casadi::Function external() const;
+
+  const std::string& library() const { return library_file; }
+  bool compiled_now() const { return compiled; }
+
+private:
+  typedef int (*Eval)(const double**, double**, casadi::casadi_int*, double*, int);
+  typedef int (*Work)(casadi::casadi_int*, casadi::casadi_int*, casadi::casadi_int*, casadi::casadi_int*);
+  typedef int (*Checkout)(void);
+  typedef void (*Release)(int);
+  typedef void (*Ref)(void);
+
+  void* symbol(const std::string& suffix) const;
+
+  std::string name, library_file;
+  bool compiled = false;
+  void* handle = nullptr;
+
+  Eval eval_fn = nullptr;
+  Release release_fn = nullptr;
+  Ref decref_fn = nullptr;
+  int mem = 0;
+  casadi::casadi_int n_in, n_out;
+
+  std::vector<const double*> arg_buf;
+  std::vector<double*> res_buf;
+  std::vector<casadi::casadi_int> iw;
+  std::vector<double> w;
+};
+
+#endif
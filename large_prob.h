@@ -0,0 +1,42 @@
+#ifndef LARGE_PROB_H
+#define LARGE_PROB_H
+
+#include <casadi/casadi.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+// NLP of "2_test_largeProb copy.cpp":
+//   min  sum_i (x_i - i)^4 + sin(x_i) + exp(0.1 x_i)
+//   s.t. x_i^2 + x_{i+1}^2 - 1 = 0,  i = 0..N-2
+//
+// T is casadi::MX or casadi::SX. With vectorized = true the objective and
+// constraints are whole-vector expressions (elementwise ops, slices, sum1),
+// so the graph has a fixed number of nodes; otherwise they are built with
+// the original scalar loop, one nested node per element.
+template <class T>
+std::map<std::string, T> large_prob_nlp(int N, bool vectorized = true) {
+  using casadi::Slice;
+  T x = T::sym("x", N);
+  T f, g;
+
+  if (vectorized) {
+    std::vector<double> idx(N);
+    for (int i = 0; i < N; ++i) idx[i] = i;
+    f = sum1(pow(x - casadi::DM(idx), 4) + sin(x) + exp(0.1 * x));
+    g = pow(x(Slice(0, N-1)), 2) + pow(x(Slice(1, N)), 2) - 1.0;
+  } else {
+    f = 0;
+    for (int i = 0; i < N; ++i)
+      f += pow(x(i) - i, 4) + sin(x(i)) + exp(0.1 * x(i));
+
+    std::vector<T> g_list;
+    for (int i = 0; i < N-1; ++i)
+      g_list.push_back(pow(x(i), 2) + pow(x(i+1), 2) - 1.0);
+    g = vertcat(g_list);
+  }
+
+  return {{"x", x}, {"f", f}, {"g", g}};
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include "mat_writer.h"
+#include <stdexcept>
+
+Mat_writer::Mat_writer(const std::string& filename, bool compress, mat_ft version, bool append)
+    : file(filename),
+      compression(compress ? MAT_COMPRESSION_ZLIB : MAT_COMPRESSION_NONE),
+      hdf5(version == MAT_FT_MAT73) {
+  matfp = append ? Mat_Open(filename.c_str(), MAT_ACC_RDWR) : NULL;
+  if (matfp) {
+    hdf5 = Mat_GetVersion(matfp) == MAT_FT_MAT73;
+    return;
+  }
+  matfp = Mat_CreateVer(filename.c_str(), NULL, version);
+  if (!matfp) throw std::runtime_error("Failed to create " + filename);
+}
+
+Mat_writer::~Mat_writer() {
+  Mat_Close(matfp);
+}
+
+// append_dim: 0 writes the whole variable, 1 / 2 appends along rows / columns
+void Mat_writer::put(const std::string& name, const void* data, matio_classes class_type,
+                     matio_types data_type, size_t rows, size_t cols, int append_dim) {
+  if (append_dim && !hdf5)
+    throw std::runtime_error("Mat_writer: appending needs a MAT 7.3 file (" + file + ")");
+
+  size_t dims[2] = {rows, cols};
+  matvar_t* matvar = Mat_VarCreate(name.c_str(), class_type, data_type,
+                                   2, dims, const_cast<void*>(data), MAT_F_DONT_COPY_DATA);
+  if (!matvar) throw std::runtime_error("Failed to create matvar " + name);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  int err = append_dim ? Mat_VarWriteAppend(matfp, matvar, compression, append_dim)
+                       : Mat_VarWrite(matfp, matvar, compression);
+  Mat_VarFree(matvar);
+  if (err) throw std::runtime_error("Failed to write " + name + " to " + file);
+}
+
+void Mat_writer::write(const std::string& name, const double* data, size_t rows, size_t cols) {
+  put(name, data, MAT_C_DOUBLE, MAT_T_DOUBLE, rows, cols, 0);
+}
+
+void Mat_writer::write(const std::string& name, const casadi::DM& data) {
+  if (!data.is_dense()) {
+    casadi::DM dense = densify(data);
+    put(name, dense.ptr(), MAT_C_DOUBLE, MAT_T_DOUBLE, dense.size1(), dense.size2(), 0);
+    return;
+  }
+  put(name, data.ptr(), MAT_C_DOUBLE, MAT_T_DOUBLE, data.size1(), data.size2(), 0);
+}
+
+void Mat_writer::write(const std::string& name, double value) {
+  put(name, &value, MAT_C_DOUBLE, MAT_T_DOUBLE, 1, 1, 0);
+}
+
+void Mat_writer::write(const std::string& name, const casadi::casadi_int* data, size_t rows, size_t cols) {
+  put(name, data, MAT_C_INT64, MAT_T_INT64, rows, cols, 0);
+}
+
+void Mat_writer::append_rows(const std::string& name, const double* data, size_t rows, size_t cols) {
+  put(name, data, MAT_C_DOUBLE, MAT_T_DOUBLE, rows, cols, 1);
+}
+
+void Mat_writer::append_cols(const std::string& name, const double* data, size_t rows, size_t cols) {
+  put(name, data, MAT_C_DOUBLE, MAT_T_DOUBLE, rows, cols, 2);
+}
+
+void Mat_writer::append_rows(const std::string& name, const casadi::DM& data) {
+  if (!data.is_dense()) {
+    casadi::DM dense = densify(data);
+    put(name, dense.ptr(), MAT_C_DOUBLE, MAT_T_DOUBLE, dense.size1(), dense.size2(), 1);
+    return;
+  }
+  put(name, data.ptr(), MAT_C_DOUBLE, MAT_T_DOUBLE, data.size1(), data.size2(), 1);
+}
@@ -0,0 +1,54 @@
+#ifndef MAT_WRITER_H
+#define MAT_WRITER_H
+
+#include <casadi/casadi.hpp>
+#include <matio.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One open MAT file for all results of a run
+//
+// Variables are written straight from the caller's buffer (a dense DM is
+// written from DM::ptr() without a copy). With the default MAT 7.3 format
+// the file is HDF5: append_rows()/append_cols() extend a chunked dataset,
+// so sweep and grid results can be written while they are computed, and
+// compress = true stores the data zlib-compressed. With append = true an
+// existing MAT 7.3 file is opened instead of replaced, so appends continue
+// its variables (e.g. successive closed-loop runs). All calls are
+// serialized, so several threads may share one writer.
+class Mat_writer {
+public:
+  explicit Mat_writer(const std::string& filename, bool compress = false,
+                      mat_ft version = MAT_FT_MAT73, bool append = false);
+  ~Mat_writer();
+
+  Mat_writer(const Mat_writer&) = delete;
+  Mat_writer& operator=(const Mat_writer&) = delete;
+
+  // Whole variable, column-major rows x cols
+  void write(const std::string& name, const double* data, size_t rows, size_t cols);
+  void write(const std::string& name, const casadi::DM& data);
+  void write(const std::string& name, double value);
+  // Integer data such as sparsity indices (Sparsity::colind(), row()), as int64
+  void write(const std::string& name, const casadi::casadi_int* data, size_t rows, size_t cols);
+
+  // Extend a variable (created on first use) by a rows x cols block
+  void append_rows(const std::string& name, const double* data, size_t rows, size_t cols);
+  void append_cols(const std::string& name, const double* data, size_t rows, size_t cols);
+  void append_rows(const std::string& name, const casadi::DM& data);
+
+  const std::string& filename() const { return file; }
+
+private:
+  void put(const std::string& name, const void* data, matio_classes class_type,
+           matio_types data_type, size_t rows, size_t cols, int append_dim);
+
+  std::string file;
+  mat_t* matfp;
+  matio_compression compression;
+  bool hdf5;
+  std::mutex mutex;
+};
+
+#endif
@@ -1,7 +1,6 @@
 function main
     global XX YY ZZ x_opt y_opt circle_x circle_y line_x line_y;
-    load_all('rosenbrock_contour.mat', 'rosenbrock_optimal_solution.mat', ...
-            'rosenbrock_constraint_1.mat', 'rosenbrock_constraint_2.mat')
+    load_all('rosenbrock.mat')
     
     [x_opt, y_opt] = rosenbrock_result();
     
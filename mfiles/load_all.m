@@ -1,6 +1,26 @@
 function load_all(varargin)
     global XX YY ZZ x_opt y_opt circle_x circle_y line_x line_y;
 
+    if nargin == 1
+        % 3_rosenbrock 가 Mat_writer 로 한 파일에 저장한 결과
+        data = load("mat/"+varargin{1});
+        XX = data.XX;
+        YY = data.YY;
+        ZZ = data.ZZ;
+        x_opt = data.x_opt;
+        y_opt = data.y_opt;
+        circle_x = []; circle_y = []; line_x = []; line_y = [];
+        if isfield(data, 'circle_x')
+            circle_x = data.circle_x;
+            circle_y = data.circle_y;
+        end
+        if isfield(data, 'line_x')
+            line_x = data.line_x;
+            line_y = data.line_y;
+        end
+        return;
+    end
+
     data1 = load("mat/"+varargin{1});  % Loads XX, YY, ZZ
     XX = data1.XX;
     YY = data1.YY;
@@ -14,4 +34,4 @@ function load_all(varargin)
     data4 = load("mat/"+varargin{4});  % Loads line_x, line_y
     line_x = data4.line_x;
     line_y = data4.line_y;
-end
\ No newline at end of file
+end
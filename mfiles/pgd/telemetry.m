@@ -0,0 +1,22 @@
+% telemetry.m
+% pgd_api (PGD_TELEMETRY=ON) 가 기록한 반복별 값을 그린다
+
+data = load("../mat/pgd_telemetry.mat");
+k = double(data.iter);
+
+figure;
+subplot(3, 1, 1);
+semilogy(k, data.FX - min(data.FX) + eps, '-o', k, data.ck - min(data.FX) + eps, '--');
+grid on; legend('FX', 'ck'); ylabel('f - f_{min}');
+title('PGD\_API\_s telemetry');
+
+subplot(3, 1, 2);
+semilogy(k, data.alpha_Y, '-o', k, data.alpha_X, 'x');
+grid on; legend('\alpha_Y', '\alpha_X'); ylabel('step');
+
+subplot(3, 1, 3);
+stairs(k, [double(data.back_iter), double(data.mon_iter), double(data.branch)]);
+grid on; legend('back\_iter', 'mon\_iter', 'branch (0=Z, 1=V)');
+xlabel('iter');
+
+fprintf('solve time: %.3f us\n', double(data.t_ns(end)) * 1e-3);
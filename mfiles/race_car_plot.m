@@ -0,0 +1,43 @@
+function race_car_plot(results_file, mpc_file)
+    % race_car / race_car_mpc 가 저장한 .mat 파일을 불러와 그린다
+    %   race_car_plot('race_car_results.mat')
+    %   race_car_plot('race_car_results.mat', 'race_car_mpc.mat')
+    if nargin < 1
+        results_file = 'race_car_results.mat';
+    end
+
+    % ---- OCP solution (4_race_car_multiple_shooting) ----
+    data = load(results_file);
+    figure;
+    hold on;
+    plot(data.t, data.speed);
+    plot(data.t, data.pos);
+    plot(data.t, 1-sin(2*pi*data.pos)/2, 'r--');
+    stairs(data.t(1:end-1), data.U, 'k');
+    xlabel('Time [s]');
+    legend('speed', 'pos', 'speed limit', 'throttle', 'Location', 'northwest');
+    title(sprintf('T = %.4f s', data.T));
+
+    if exist('race_car_jac_g.mat', 'file')
+        figure;
+        sparsity_plot('race_car_jac_g.mat');
+        xlabel('decision variables');
+        ylabel('constraints');
+        print('jac_sp', '-dpng');
+    end
+
+    % ---- closed-loop MPC log (5_race_car_mpc) ----
+    if nargin >= 2
+        mpc = load(mpc_file);
+        figure;
+        subplot(3, 1, 1);
+        plot(mpc.t, mpc.speed, mpc.t, 1-sin(2*pi*mpc.pos)/2, 'r--');
+        ylabel('speed'); legend('speed', 'speed limit'); grid on;
+        subplot(3, 1, 2);
+        stairs(mpc.t, mpc.U, 'k');
+        ylabel('throttle'); grid on;
+        subplot(3, 1, 3);
+        semilogy(mpc.t, mpc.latency);
+        ylabel('solve time [s]'); xlabel('Time [s]'); grid on;
+    end
+end
@@ -0,0 +1,31 @@
+function sparsity_plot(file, prefix)
+    % save_sparsity (sparsity_export.cpp) 가 저장한 패턴을 그린다
+    % 작은 패턴은 spy, 큰 패턴은 downsample 된 density image
+    if nargin < 2
+        prefix = '';
+    end
+    data = load(file);
+    sz = double(data.([prefix 'size']));
+    nrow = sz(1); ncol = sz(2); nnz_total = sz(3);
+
+    if nnz_total <= 1e6
+        if isfield(data, [prefix 'row_ptr'])
+            row_ptr = double(data.([prefix 'row_ptr']));
+            row = repelem((1:nrow)', diff(row_ptr));
+        else
+            row = double(data.([prefix 'row'])) + 1;
+        end
+        col = double(data.([prefix 'col'])) + 1;
+        spy(sparse(row, col, 1, nrow, ncol));
+    else
+        image = data.([prefix 'image']);
+        imagesc([1 ncol], [1 nrow], log10(image + eps));
+        colormap(flipud(gray)); colorbar;
+        axis image;
+    end
+
+    bw = data.([prefix 'bandwidth']);
+    colors = data.([prefix 'colors']);
+    title(sprintf('%d x %d, nnz %d, bw %d/%d, colors %d/%d', nrow, ncol, nnz_total, ...
+          bw(1), bw(2), colors(1), colors(2)));
+end
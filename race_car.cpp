@@ -0,0 +1,94 @@
+#include "race_car.h"
+#include <thread>
+#include <algorithm>
+
+using namespace casadi;
+
+// dx/dt = f(x,u)
+template <class T>
+static T f(const T& x, const T& u) {
+  return vertcat(x(1), u-x(1));
+}
+
+template <class T>
+static T rk4(const T& x, const T& u, const T& dt) {
+  T k1 = f(x,         u);
+  T k2 = f(x+dt/2*k1, u);
+  T k3 = f(x+dt/2*k2, u);
+  T k4 = f(x+dt*k3,   u);
+  return x + dt/6*(k1+2*k2+2*k3+k4);
+}
+
+// One RK4 step of the race car dynamics: x_next = rk4(x, u, dt)
+Function race_car_rk4() {
+  SX x = SX::sym("x", 2);
+  SX u = SX::sym("u");
+  SX dt = SX::sym("dt");
+  return Function("rk4", {x, u, dt}, {rk4(x, u, dt)}, {"x", "u", "dt"}, {"x_next"});
+}
+
+// Predicted states X(:,1:N) from X(:,0:N-1) and U
+//
+// "serial", "openmp" and "thread" apply one rk4 Function over the horizon
+// with Function::map, so the NLP graph holds a single call node whatever N
+// is. "inline" expands every step into the graph, as the original loop did.
+MX race_car_shooting(const MX& X, const MX& U, const MX& dt, const std::string& parallelization) {
+  casadi_int N = U.size2();
+  Slice all;
+
+  if (parallelization == "inline") {
+    std::vector<MX> x_next;
+    for (casadi_int k=0;k<N;++k)
+      x_next.push_back(rk4<MX>(X(all,k), U(all,k), dt));
+    return horzcat(x_next);
+  }
+
+  Function F = race_car_rk4();
+  Function F_map = parallelization == "thread"
+    ? F.map(N, "thread", std::max(1u, std::thread::hardware_concurrency()))
+    : F.map(N, parallelization);
+  return F_map(std::vector<MX>{X(all,Slice(0,N)), U, repmat(dt, 1, N)})[0];
+}
+
+// Minimum-time race car OCP of 4_race_car_multiple_shooting.cpp with horizon N
+//
+// The car starts at x0 (position; speed) and finishes one lap ahead of it.
+// The default x0 = 0 is the original problem; an opti.parameter() makes it
+// the MPC problem re-solved from each measured state.
+Race_car_ocp race_car_ocp(Opti& opti, int N, const std::string& parallelization, const MX& x0) {
+  Slice all;
+  // ---- decision variables ---------
+  Race_car_ocp ocp;
+  ocp.X = opti.variable(2,N+1); // state trajectory
+  ocp.U = opti.variable(1,N);   // control trajectory (throttle)
+  ocp.T = opti.variable();      // final time
+  MX pos   = ocp.X(0,all);
+  MX speed = ocp.X(1,all);
+
+  // ---- objective          ---------
+  opti.minimize(ocp.T); // race in minimal time
+
+  // ---- dynamic constraints --------
+  MX dt = ocp.T/N;
+  ocp.con_dyn = ocp.X(all,Slice(1,N+1))==race_car_shooting(ocp.X, ocp.U, dt, parallelization); // close the gaps
+
+  // ---- path constraints -----------
+  ocp.con_speed = speed<=1-sin(2*pi*pos)/2; // track speed limit
+  ocp.con_u = 0<=ocp.U<=1;                  // control is limited
+
+  // ---- boundary conditions --------
+  ocp.con_x0 = ocp.X(all,0)==x0;  // start at x0 ...
+  ocp.con_end = pos(N)==x0(0)+1;  // ... and finish one lap ahead
+
+  // ---- misc. constraints  ----------
+  ocp.con_T = ocp.T>=0; // Time must be positive
+
+  for (const MX& con : {ocp.con_dyn, ocp.con_speed, ocp.con_u, ocp.con_x0, ocp.con_end, ocp.con_T})
+    opti.subject_to(con);
+
+  // ---- initial values for solver ---
+  opti.set_initial(speed, 1);
+  opti.set_initial(ocp.T, 1);
+
+  return ocp;
+}
@@ -0,0 +1,29 @@
+#ifndef RACE_CAR_H
+#define RACE_CAR_H
+
+#include <casadi/casadi.hpp>
+#include <string>
+
+// Decision variables and constraints of the race car OCP
+struct Race_car_ocp {
+  casadi::MX X; // state trajectory (pos; speed), 2 x N+1
+  casadi::MX U; // control trajectory (throttle), 1 x N
+  casadi::MX T; // final time
+
+  // The constraints as passed to subject_to, in that order, e.g. for
+  // opti.dual() or for the row layout of opti.g()
+  casadi::MX con_dyn;   // gaps closed, 2 x N
+  casadi::MX con_speed; // track speed limit, 1 x N+1
+  casadi::MX con_u;     // throttle limits, 1 x N
+  casadi::MX con_x0;    // initial state, 2 x 1
+  casadi::MX con_end;   // finish line one lap ahead, 1 x 1
+  casadi::MX con_T;     // positive time, 1 x 1
+};
+
+casadi::Function race_car_rk4();
+casadi::MX race_car_shooting(const casadi::MX& X, const casadi::MX& U, const casadi::MX& dt,
+                             const std::string& parallelization = "serial");
+Race_car_ocp race_car_ocp(casadi::Opti& opti, int N, const std::string& parallelization = "serial",
+                          const casadi::MX& x0 = casadi::MX::zeros(2, 1));
+
+#endif
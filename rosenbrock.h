@@ -2,13 +2,13 @@
 #define ROSENBROCK_H
 
 #include <casadi/casadi.hpp>
-#include <matio.h>
+#include "mat_writer.h"
 
-std::pair<casadi::DM, casadi::DM> meshgrid(const casadi::DM& x, const casadi::DM& y);
-void save_dm(const casadi::DM& data, const char* name, mat_t* matfp);
-void save_contour(const casadi::DM& XX, const casadi::DM& YY, const casadi::DM& ZZ);
-void save_optimal_solution( double x_opt, double y_opt);
-void save_constraint_1(double r = 1);
-void save_constraint_2();
+void save_grid(Mat_writer& out, const casadi::Function& f, const casadi::DM& x, const casadi::DM& y,
+               const std::string& name, size_t tile_bytes = 256 * 1024);
+void save_contour(Mat_writer& out, const casadi::Function& f, const casadi::DM& x, const casadi::DM& y);
+void save_optimal_solution(Mat_writer& out, double x_opt, double y_opt);
+void save_constraint_1(Mat_writer& out, double r = 1);
+void save_constraint_2(Mat_writer& out);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "solver_cache.h"
+#include <unistd.h>
+#include <atomic>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+
+namespace fs = std::filesystem;
+
+// 64-bit FNV-1a
+static uint64_t fnv1a(const std::string& data, uint64_t h = 14695981039346656037ull) {
+  for (unsigned char c : data) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+// Hash of data as 16 hex digits
+std::string cache_key(const std::string& data) {
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << fnv1a(data);
+  return key.str();
+}
+
+// Hash of everything that determines the built solver: the serialized NLP
+// expressions, the plugin name, the options and the CasADi version
+std::string nlpsol_cache_key(const std::string& solver, const casadi::MXDict& nlp, const casadi::Dict& opts) {
+  std::vector<casadi::MX> in, out;
+  std::vector<std::string> in_names, out_names;
+  for (const std::string& s : {"x", "p"})
+    if (nlp.count(s)) { in.push_back(nlp.at(s)); in_names.push_back(s); }
+  for (const std::string& s : {"f", "g"})
+    if (nlp.count(s)) { out.push_back(nlp.at(s)); out_names.push_back(s); }
+  casadi::Function oracle("nlp", in, out, in_names, out_names);
+
+  std::ostringstream desc;
+  desc << solver << '\n' << casadi::str(opts) << '\n' << casadi::CasadiMeta::version() << '\n';
+  return cache_key(desc.str() + oracle.serialize());
+}
+
+// nlpsol with an on-disk cache
+//
+// The first call for a given NLP/options builds the solver and saves it with
+// CasADi serialization to cache_dir/<name>_<key>.casadi; later calls, also
+// from later runs, load that file instead. Any change of the expressions or
+// options changes the key, so stale entries are never picked up. A file that
+// fails to load (e.g. written by another CasADi version) is rebuilt.
+casadi::Function cached_nlpsol(const std::string& name, const std::string& solver,
+                               const casadi::MXDict& nlp, const casadi::Dict& opts,
+                               const std::string& cache_dir) {
+  fs::path file = fs::path(cache_dir) / (name + "_" + nlpsol_cache_key(solver, nlp, opts) + ".casadi");
+
+  if (fs::exists(file)) {
+    try {
+      return casadi::Function::load(file.string());
+    } catch (const std::exception& e) {
+      casadi::uerr() << "Rebuilding " << file << ": " << e.what() << std::endl;
+    }
+  }
+
+  casadi::Function f = casadi::nlpsol(name, solver, nlp, opts);
+
+  // Write under a name private to this save, then rename: concurrent builds,
+  // in other processes or threads, never share a partial file, and the rename
+  // is atomic, so a reader sees either no file or the whole solver
+  fs::create_directories(cache_dir);
+  static std::atomic<unsigned> n_saved{0};
+  fs::path tmp = file;
+  tmp += "." + std::to_string(getpid()) + "_" + std::to_string(n_saved++) + ".tmp";
+  try {
+    f.save(tmp.string());
+  } catch (...) {
+    fs::remove(tmp);
+    throw;
+  }
+  fs::rename(tmp, file);
+  return f;
+}
@@ -0,0 +1,13 @@
+#ifndef SOLVER_CACHE_H
+#define SOLVER_CACHE_H
+
+#include <casadi/casadi.hpp>
+#include <string>
+
+std::string cache_key(const std::string& data);
+std::string nlpsol_cache_key(const std::string& solver, const casadi::MXDict& nlp, const casadi::Dict& opts);
+casadi::Function cached_nlpsol(const std::string& name, const std::string& solver,
+                               const casadi::MXDict& nlp, const casadi::Dict& opts = casadi::Dict(),
+                               const std::string& cache_dir = "solver_cache");
+
+#endif
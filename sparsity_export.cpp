@@ -0,0 +1,97 @@
+#include "sparsity_export.h"
+#include <algorithm>
+#include <vector>
+
+using casadi::casadi_int;
+
+Sparsity_stats sparsity_stats(const casadi::Sparsity& sp) {
+  Sparsity_stats st;
+  st.nrow = sp.size1();
+  st.ncol = sp.size2();
+  st.nnz = sp.nnz();
+  st.bw_lower = sp.bw_lower();
+  st.bw_upper = sp.bw_upper();
+
+  // Rows of the CCS pattern give the nonzeros per row in one pass
+  std::vector<casadi_int> nnz_row(st.nrow, 0);
+  const casadi_int* row = sp.row();
+  for (casadi_int k = 0; k < st.nnz; ++k) nnz_row[row[k]]++;
+  st.nnz_row_min = st.nrow ? *std::min_element(nnz_row.begin(), nnz_row.end()) : 0;
+  st.nnz_row_max = st.nrow ? *std::max_element(nnz_row.begin(), nnz_row.end()) : 0;
+  st.nnz_row_mean = st.nrow ? double(st.nnz) / st.nrow : 0;
+
+  // Number of colors = number of directional derivatives for the Jacobian
+  casadi::Sparsity spT = sp.T();
+  st.colors_fwd = sp.uni_coloring(spT).size2();
+  st.colors_rev = spT.uni_coloring(sp).size2();
+  return st;
+}
+
+void print_sparsity_stats(const Sparsity_stats& st, std::ostream& out) {
+  out << "sparsity: " << st.nrow << " x " << st.ncol << ", nnz " << st.nnz
+      << " (" << 100.0 * st.nnz / std::max<double>(1, double(st.nrow) * st.ncol) << " %)" << std::endl;
+  out << "  bandwidth lower/upper: " << st.bw_lower << " / " << st.bw_upper << std::endl;
+  out << "  nnz per row min/mean/max: " << st.nnz_row_min << " / " << st.nnz_row_mean
+      << " / " << st.nnz_row_max << std::endl;
+  out << "  colors forward/reverse: " << st.colors_fwd << " / " << st.colors_rev << std::endl;
+}
+
+// Variables written (prefix omitted):
+//   CSR (default): row_ptr (nrow+1), col (nnz), 0-based
+//   COO (coo):     row (nnz), col (nnz), 0-based
+//   size = [nrow ncol nnz], bandwidth = [lower upper], colors = [forward reverse],
+//   nnz_row (nrow), image: nonzero density of each block of an at most
+//   image_size x image_size grid over the matrix
+void save_sparsity(Mat_writer& out, const casadi::Sparsity& sp, const std::string& prefix,
+                   bool coo, casadi_int image_size) {
+  Sparsity_stats st = sparsity_stats(sp);
+  casadi_int nrow = st.nrow, ncol = st.ncol, nnz = st.nnz;
+
+  if (coo) {
+    std::vector<casadi_int> row, col;
+    sp.get_triplet(row, col);
+    out.write(prefix + "row", row.data(), nnz, 1);
+    out.write(prefix + "col", col.data(), nnz, 1);
+  } else {
+    // The CCS arrays of the transpose are the CSR arrays of sp
+    casadi::Sparsity spT = sp.T();
+    out.write(prefix + "row_ptr", spT.colind(), nrow + 1, 1);
+    out.write(prefix + "col", spT.row(), nnz, 1);
+  }
+
+  double size[] = {double(nrow), double(ncol), double(nnz)};
+  double bandwidth[] = {double(st.bw_lower), double(st.bw_upper)};
+  double colors[] = {double(st.colors_fwd), double(st.colors_rev)};
+  out.write(prefix + "size", size, 1, 3);
+  out.write(prefix + "bandwidth", bandwidth, 1, 2);
+  out.write(prefix + "colors", colors, 1, 2);
+
+  std::vector<double> nnz_row(nrow, 0);
+  const casadi_int* colind = sp.colind();
+  const casadi_int* row = sp.row();
+  for (casadi_int k = 0; k < nnz; ++k) nnz_row[row[k]]++;
+  out.write(prefix + "nnz_row", nnz_row.data(), nrow, 1);
+
+  // Density image, column-major: row r falls in block row r*h/nrow and column
+  // c in block column c*w/ncol; each block is divided by the number of
+  // entries it covers, counted with the same mapping
+  casadi_int h = std::max<casadi_int>(1, std::min(image_size, nrow));
+  casadi_int w = std::max<casadi_int>(1, std::min(image_size, ncol));
+  std::vector<double> image(h * w, 0), rows_in(h, 0), cols_in(w, 0);
+  for (casadi_int r = 0; r < nrow; ++r) rows_in[r * h / nrow]++;
+  for (casadi_int c = 0; c < ncol; ++c) {
+    casadi_int j = c * w / ncol;
+    cols_in[j]++;
+    for (casadi_int k = colind[c]; k < colind[c+1]; ++k)
+      image[j * h + row[k] * h / nrow] += 1;
+  }
+  for (casadi_int j = 0; j < w; ++j)
+    for (casadi_int i = 0; i < h; ++i)
+      image[j * h + i] /= std::max(1.0, rows_in[i] * cols_in[j]);
+  out.write(prefix + "image", image.data(), h, w);
+}
+
+casadi::Sparsity jac_g_sparsity(const casadi::Opti& opti) {
+  casadi::Function g("g", {opti.x(), opti.p()}, {opti.g()});
+  return g.jac_sparsity(0, 0);
+}
@@ -0,0 +1,28 @@
+#ifndef SPARSITY_EXPORT_H
+#define SPARSITY_EXPORT_H
+
+#include <casadi/casadi.hpp>
+#include <iostream>
+#include <string>
+#include "mat_writer.h"
+
+// Structure summary of a sparsity pattern
+struct Sparsity_stats {
+  casadi::casadi_int nrow, ncol, nnz;
+  casadi::casadi_int bw_lower, bw_upper;       // lower / upper bandwidth
+  casadi::casadi_int nnz_row_min, nnz_row_max;
+  double nnz_row_mean;
+  casadi::casadi_int colors_fwd, colors_rev;   // column / row colorings (forward / reverse sweeps)
+};
+
+Sparsity_stats sparsity_stats(const casadi::Sparsity& sp);
+void print_sparsity_stats(const Sparsity_stats& st, std::ostream& out = std::cout);
+
+// Write sp as int64 index arrays with its stats and a downsampled density image
+void save_sparsity(Mat_writer& out, const casadi::Sparsity& sp, const std::string& prefix = "",
+                   bool coo = false, casadi::casadi_int image_size = 1024);
+
+// Jacobian sparsity of opti.g() w.r.t. opti.x(), without forming the symbolic Jacobian
+casadi::Sparsity jac_g_sparsity(const casadi::Opti& opti);
+
+#endif